@@ -34,7 +34,7 @@ void logJson(JsonDocument jsondata) {
   char JSONmessageBuffer[JSON_MSG_BUFFER];
   serializeJson(jsondata, JSONmessageBuffer, JSON_MSG_BUFFER);
 #endif
-#if defined(setBitrate) || defined(setFreqDev) || defined(setRxBW)
+#ifdef AUTOTUNE
   Log.setShowLevel(false);
   Log.notice(F("."));
   Log.setShowLevel(true);
@@ -57,89 +57,11 @@ void setup() {
   rf.enableReceiver();
   Log.notice(F("****** setup complete ******" CR));
   rf.getModuleStatus();
-}
-
-unsigned long uptime() {
-  static unsigned long lastUptime = 0;
-  static unsigned long uptimeAdd = 0;
-  unsigned long uptime = millis() / 1000 + uptimeAdd;
-  if (uptime < lastUptime) {
-    uptime += 4294967;
-    uptimeAdd += 4294967;
-  }
-  lastUptime = uptime;
-  return uptime;
-}
-
-int next = uptime() + 30;
-
-#if defined(setBitrate) || defined(setFreqDev) || defined(setRxBW)
-
-#  ifdef setBitrate
-#    define TEST    "setBitrate" // 17.24 was suggested
-#    define STEP    2
-#    define stepMin 1
-#    define stepMax 300
-// #    define STEP    1
-// #    define stepMin 133
-// #    define stepMax 138
-#  elif defined(setFreqDev) // 40 kHz was suggested
-#    define TEST    "setFrequencyDeviation"
-#    define STEP    1
-#    define stepMin 5
-#    define stepMax 200
-#  elif defined(setRxBW)
-#    define TEST "setRxBandwidth"
-
-#    ifdef defined(RF_SX1276) || defined(RF_SX1278)
-#      define STEP    5
-#      define stepMin 5
-#      define stepMax 250
-#    else
-#      define STEP    5
-#      define stepMin 58
-#      define stepMax 812
-// #      define STEP    0.01
-// #      define stepMin 202.00
-// #      define stepMax 205.00
-#    endif
-#  endif
-float step = stepMin;
+#ifdef AUTOTUNE
+  rf.startAutotune();
 #endif
+}
 
 void loop() {
   rf.loop();
-#if defined(setBitrate) || defined(setFreqDev) || defined(setRxBW)
-  char stepPrint[8];
-  if (uptime() > next) {
-    next = uptime() + 120; // 60 seconds
-    dtostrf(step, 7, 2, stepPrint);
-    Log.notice(F(CR "Finished %s: %s, count: %d" CR), TEST, stepPrint, count);
-    step += STEP;
-    if (step > stepMax) {
-      step = stepMin;
-    }
-    dtostrf(step, 7, 2, stepPrint);
-    Log.notice(F("Starting %s with %s" CR), TEST, stepPrint);
-    count = 0;
-
-    int16_t state = 0;
-#  ifdef setBitrate
-    state = rf.setBitRate(step);
-    RADIOLIB_STATE(state, TEST);
-#  elif defined(setFreqDev)
-    state = rf.setFrequencyDeviation(step);
-    RADIOLIB_STATE(state, TEST);
-#  elif defined(setRxBW)
-    state = rf.setRxBandwidth(step);
-    if ((state) != RADIOLIB_ERR_NONE) {
-      Log.notice(F(CR "Setting  %s: to %s, failed" CR), TEST, stepPrint);
-      next = uptime() - 1;
-    }
-#  endif
-
-    rf.receiveDirect();
-    // rf.getModuleStatus();
-  }
-#endif
 }
\ No newline at end of file
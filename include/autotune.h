@@ -0,0 +1,79 @@
+/** @file
+    Receiver parameter autotuner.
+
+    Coordinate descent over a few receiver parameters (bit rate, bandwidth,
+    deviation, thresholds).  Each configuration is scored by the caller,
+    usually decoded messages per minute, and a parameter keeps moving in one
+    direction while the score improves.  When a full pass gives no
+    improvement the steps are halved until they reach their minimum.
+
+    The tuner only does the bookkeeping, applying a configuration and
+    measuring its score is up to the caller, so it runs the same against
+    a radio or a simulated one.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_AUTOTUNE_H_
+#define INCLUDE_AUTOTUNE_H_
+
+#ifndef AUTOTUNE_MAX_PARAMS
+#  define AUTOTUNE_MAX_PARAMS 6
+#endif
+
+typedef struct autotune_param {
+  char const* name;
+  float min;
+  float max;
+  float step;     ///< current step, halved after a pass without improvement
+  float min_step; ///< tuning of this parameter ends below this step
+  float value;    ///< value of the configuration to try
+  float best;     ///< best value found so far
+} autotune_param_t;
+
+typedef enum {
+  AUTOTUNE_BASELINE, ///< scoring the start configuration
+  AUTOTUNE_UP,       ///< moving the current parameter up
+  AUTOTUNE_DOWN,     ///< moving the current parameter down
+  AUTOTUNE_DONE,
+} autotune_state_t;
+
+typedef struct autotune {
+  autotune_param_t params[AUTOTUNE_MAX_PARAMS];
+  unsigned num_params;
+  unsigned param;       ///< parameter being tuned
+  autotune_state_t state;
+  int moved;            ///< a move in the current direction was accepted
+  int improved;         ///< a move was accepted in the current pass
+  float best_score;
+  float min_gain;       ///< score improvement needed to accept a move
+  unsigned trials;      ///< configurations scored
+  unsigned max_trials;  ///< stop after this many, 0 for no limit
+} autotune_t;
+
+/// Score a configuration, the values to score are in params[].value.
+typedef float (*autotune_score_fn)(autotune_t* at, void* ctx);
+
+/// Start a new search, parameters are kept.
+void autotune_init(autotune_t* at, float min_gain, unsigned max_trials);
+
+/// Add a parameter with the current setting as start value.
+/// Returns 0 on success, -1 if the table is full.
+int autotune_add_param(autotune_t* at, char const* name, float min, float max, float step, float min_step, float value);
+
+/// Return the value of a parameter by name, or dflt if there is no such parameter.
+float autotune_value(autotune_t const* at, char const* name, float dflt);
+
+/// Report the score of the configuration in params[].value.
+/// Returns 1 if params[].value holds the next configuration to score,
+/// 0 if the search is done and params[].value holds the best configuration.
+int autotune_next(autotune_t* at, float score);
+
+/// Run a whole search synchronously, e.g. against a simulated radio.
+/// Returns the number of configurations scored.
+unsigned autotune_run(autotune_t* at, autotune_score_fn score_fn, void* ctx);
+
+#endif /* INCLUDE_AUTOTUNE_H_ */
@@ -137,6 +137,7 @@ unsigned bitbuffer_count_repeats(bitbuffer_t *bits, unsigned row, unsigned max_b
 
 /// Find a row repeated at least @p min_repeats times and with at least @p min_bits bits length,
 /// all bits in the repeats need to match.
+/// With REPEAT_VOTE a majority vote of the rows is added and returned instead, see bitbuffer_vote.h.
 /// @return the row index or -1.
 int bitbuffer_find_repeated_row(bitbuffer_t *bits, unsigned min_repeats, unsigned min_bits);
 
@@ -0,0 +1,45 @@
+/** @file
+    Search index of the patterns decoders look for in shared slices.
+
+    With SEARCH_INDEX bitbuffer_search() learns the preamble and sync
+    patterns the decoders search for.  All learned patterns are compiled
+    into one Aho-Corasick automaton over bits, a single pass over a row of
+    a shared slice, see bitbuffer_view.h, finds every occurrence of every
+    pattern and later searches of the row are answered from that list.
+    Rows that are not shared, changed by a decoder, or that have more
+    occurrences than kept are searched bit by bit as before.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_BITBUFFER_INDEX_H_
+#define INCLUDE_BITBUFFER_INDEX_H_
+
+#include "bitbuffer.h"
+
+#if defined(SEARCH_INDEX) && !defined(SHARED_SLICES)
+#  error "SEARCH_INDEX needs SHARED_SLICES"
+#endif
+
+#ifndef SEARCH_INDEX_PATTERNS
+#  define SEARCH_INDEX_PATTERNS 32 ///< patterns learned, more are searched bit by bit
+#endif
+
+#ifndef SEARCH_INDEX_HITS
+#  define SEARCH_INDEX_HITS 1024 ///< occurrences kept per slice
+#endif
+
+#define SEARCH_INDEX_ROWS 4         ///< rows indexed per slice
+#define SEARCH_INDEX_PATTERN_BITS 64 ///< longest pattern learned
+
+/// Answer bitbuffer_search() from the index, returns 0 if it must search itself.
+int bitbuffer_index_search(bitbuffer_t const* bitbuffer, unsigned row, unsigned start,
+        uint8_t const* pattern, unsigned pattern_bits_len, unsigned* pos);
+
+/// Patterns learned, searches answered and searches done bit by bit.
+void bitbuffer_index_stats(unsigned* patterns, unsigned* answered, unsigned* searched);
+
+#endif /* INCLUDE_BITBUFFER_INDEX_H_ */
@@ -0,0 +1,60 @@
+/** @file
+    Shared slices and their derived forms.
+
+    With SHARED_SLICES the decoders of the same modulation and timing get
+    one slice per train.  Each decoder works on a copy that is restored
+    from the slice before the next decoder runs, so decoders that change
+    the bitbuffer in place stay correct.
+
+    The derived forms, inverted, NRZS or NRZM decoded and the Manchester
+    decoding of a row from a bit offset, are computed once per slice for
+    all decoders that ask for them.  A decoder uses the functions here
+    instead of bitbuffer_invert(), bitbuffer_nrzs_decode(),
+    bitbuffer_nrzm_decode() and bitbuffer_manchester_decode() and must
+    not change a bitbuffer it got from them.  Without a shared slice they
+    work in place as the bitbuffer functions do.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_BITBUFFER_VIEW_H_
+#define INCLUDE_BITBUFFER_VIEW_H_
+
+#include "bitbuffer.h"
+
+#ifndef SLICE_VIEW_MANCHESTER
+#  define SLICE_VIEW_MANCHESTER 4 ///< Manchester decodings kept per slice
+#endif
+
+#define SLICE_VIEW_MANCHESTER_BITS 256 ///< longest Manchester decoding kept
+
+/// Start sharing the slice in bits, the decoders get bits itself.
+void bitbuffer_view_begin(bitbuffer_t* bits);
+
+/// Restore the slice for the next decoder, returns 0 if it could not be kept.
+int bitbuffer_view_restore(bitbuffer_t* bits);
+
+/// Stop sharing the slice, the derived forms are dropped.
+void bitbuffer_view_end(void);
+
+/// The unchanged slice or derived form bits is a copy of or is, NULL if
+/// bits is not shared.  The key differs for every slice and form.
+bitbuffer_t const* bitbuffer_view_source(bitbuffer_t const* bits, unsigned* key);
+
+/// Inverted bits, returns the bitbuffer to use instead of bits.
+bitbuffer_t* bitbuffer_view_invert(bitbuffer_t* bits);
+
+/// NRZS decoded bits, returns the bitbuffer to use instead of bits.
+bitbuffer_t* bitbuffer_view_nrzs_decode(bitbuffer_t* bits);
+
+/// NRZM decoded bits, returns the bitbuffer to use instead of bits.
+bitbuffer_t* bitbuffer_view_nrzm_decode(bitbuffer_t* bits);
+
+/// bitbuffer_manchester_decode() with the decoding of a shared slice or
+/// its derived forms kept for the next decoder.
+unsigned bitbuffer_view_manchester_decode(bitbuffer_t* inbuf, unsigned row, unsigned start, bitbuffer_t* outbuf, unsigned max);
+
+#endif /* INCLUDE_BITBUFFER_VIEW_H_ */
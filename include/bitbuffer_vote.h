@@ -0,0 +1,42 @@
+/** @file
+    Majority vote of repeated rows.
+
+    Weak transmissions often have a flipped or lost bit in each repeat, so
+    no two repeats match and bitbuffer_find_repeated_row() gives up.  The
+    vote aligns the rows of about the same length by up to REPEAT_VOTE_SLIP
+    bits and takes the majority of every bit.
+
+    With REPEAT_VOTE bitbuffer_find_repeated_row() votes when no row is
+    repeated exactly, the decoders then check the voted row as any other.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_BITBUFFER_VOTE_H_
+#define INCLUDE_BITBUFFER_VOTE_H_
+
+#include "bitbuffer.h"
+
+#define REPEAT_VOTE_SLIP 2     ///< bits a row may be longer, shorter or shifted
+#define REPEAT_VOTE_MIN_ROWS 3 ///< rows needed for a majority that can differ from a row
+
+/// Add the majority vote of the rows of the most common length of at
+/// least @p min_bits bits, and of the rows up to REPEAT_VOTE_SLIP bits
+/// longer or shorter, as a new row.
+///
+/// A row takes part if, at its best shift, at most one bit in eight
+/// differs from the first row of the most common length.
+///
+/// @param bits the rows to vote, the voted row is added
+/// @param min_rows least number of rows that must take part
+/// @param min_bits least number of bits of the rows
+/// @param[out] agree if not NULL, for every bit of the voted row the number
+///             of rows that agree, BITBUF_COLS * 8 entries
+/// @return the index of the voted row, or -1 if too few rows take part,
+///         a bit has no majority, or there is no free row
+int bitbuffer_vote_rows(bitbuffer_t* bits, unsigned min_rows, unsigned min_bits, uint8_t* agree);
+
+#endif /* INCLUDE_BITBUFFER_VOTE_H_ */
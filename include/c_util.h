@@ -20,4 +20,21 @@
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
 #endif
 
+// Per-thread storage for the decoder state, only the host tools run the
+// decoders on several threads. Thread locals cost TLS setup on the device.
+#if defined(ESP_PLATFORM) || defined(ARDUINO)
+#define R_THREAD_LOCAL
+#elif defined(_MSC_VER)
+#define R_THREAD_LOCAL __declspec(thread)
+#else
+#define R_THREAD_LOCAL _Thread_local
+#endif
+
+// Inline even at -Os, for cores specialized with constant arguments.
+#if defined(_MSC_VER)
+#define R_ALWAYS_INLINE __forceinline
+#else
+#define R_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
 #endif /* INCLUDE_C_UTIL_H_ */
@@ -244,4 +244,13 @@ R_API void print_array_value(data_output_t *output, data_array_t *array,
 
 R_API size_t data_print_jsons(data_t *data, char *dst, size_t len);
 
+/** Encode data as CBOR (RFC 8949) into a buffer.
+
+    Objects are maps, arrays are arrays, doubles are single precision
+    floats when no precision is lost.
+
+    @return the encoded length, 0 if the message does not fit into len bytes
+*/
+R_API size_t data_print_cbor(data_t *data, unsigned char *dst, size_t len);
+
 #endif // INCLUDE_DATA_H_
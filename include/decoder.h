@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include "r_device.h"
 #include "bitbuffer.h"
+#include "bitbuffer_view.h"
 #include "data.h"
 #include "c_util.h"
 #include "bit_util.h"
@@ -31,6 +31,13 @@
 /// Create a new r_device, copy from dev_template if not NULL.
 r_device *create_device(r_device const *dev_template);
 
+/// Create a new r_device, copy from dev_template if not NULL,
+/// with user_data_size bytes of zeroed user data.
+r_device *decoder_create(r_device const *dev_template, unsigned user_data_size);
+
+/// Get the user data of a r_device created with decoder_create().
+void *decoder_user_data(r_device *decoder);
+
 /// Output data.
 void decoder_output_data(r_device *decoder, data_t *data);
 
@@ -0,0 +1,91 @@
+/** @file
+    Compact pulse analyzer that proposes a flex decoder.
+
+    Accumulates pulse, gap and period width histograms over several
+    undecoded trains of an unknown device, guesses the modulation and
+    timing with the rules of pulse_analyzer() and reports a flex decoder
+    specification with the statistics as a message.  Unlike
+    pulse_analyzer() it keeps no pulse copies or hex strings, the state
+    is about 1.2 KB and the analysis runs on the decoder task stack.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_FLEX_ANALYZER_H_
+#define INCLUDE_FLEX_ANALYZER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct pulse_data;
+struct data;
+
+#define FLEX_ANALYZER_BINS 16
+
+typedef struct flex_bin {
+  unsigned count;
+  uint64_t sum;
+  int mean;
+  int min;
+  int max;
+} flex_bin_t;
+
+typedef struct flex_hist {
+  unsigned bins_count;
+  flex_bin_t bins[FLEX_ANALYZER_BINS];
+} flex_hist_t;
+
+/// Modulation and timing guess, widths in us.
+typedef struct flex_guess {
+  unsigned modulation; ///< r_device modulation, 0 if no guess
+  char const* coding;  ///< description of the guess
+  float short_width;
+  float long_width;
+  float gap_limit;
+  float reset_limit;
+  float sync_width;
+  float tolerance;
+} flex_guess_t;
+
+typedef struct flex_analyzer {
+  int active;
+  int fsk;                 ///< trains are FSK
+  unsigned trains_wanted;  ///< analysis completes after this many trains
+  unsigned min_pulses;     ///< shorter trains are skipped
+
+  /* statistics */
+  unsigned trains;
+  unsigned pulses;
+  unsigned min_train_pulses;
+  unsigned max_train_pulses;
+  uint32_t sample_rate;
+  long rssi_sum;
+  flex_hist_t hist_pulses;
+  flex_hist_t hist_gaps;
+  flex_hist_t hist_periods;
+} flex_analyzer_t;
+
+/// Start collecting trains, previous statistics are cleared.
+void flex_analyzer_start(flex_analyzer_t* fa, unsigned trains, unsigned min_pulses, int fsk);
+
+/// Add an undecoded train.
+/// Returns 1 once trains_wanted trains were added, 0 otherwise.
+int flex_analyzer_add(flex_analyzer_t* fa, struct pulse_data const* pulses);
+
+/// Guess the modulation and timing from the trains added so far.
+/// Bins with less than 2% of the widths are ignored, they are glitches.
+void flex_analyzer_guess(flex_analyzer_t const* fa, flex_guess_t* guess);
+
+/// Format the flex decoder specification of a guess, "n=name,m=OOK_PWM,s=...".
+/// Returns the length as snprintf(), 0 if there is no guess.
+int flex_analyzer_spec(flex_guess_t const* guess, char const* name, char* buf, size_t size);
+
+/// Stop collecting and build the result message.
+/// If pulses is not NULL the train is sliced with the guess and the rows
+/// are reported, the trailing gap of the train is changed for this.
+struct data* flex_analyzer_report(flex_analyzer_t* fa, struct pulse_data* pulses);
+
+#endif /* INCLUDE_FLEX_ANALYZER_H_ */
@@ -0,0 +1,56 @@
+/** @file
+    Noise train rejection before a train is queued for decoding.
+
+    Most trains a receiver picks up on a busy band are noise, the OOK
+    slicer fluttering on the noise floor.  Their pulse and gap widths are
+    spread over a wide range, while the widths of a real transmission fall
+    into a few clusters (the symbol widths) with a sane duty cycle.  The
+    regularity score is the share of widths that fall into the
+    NOISE_CLUSTERS widest clusters of a log width histogram, the lower of
+    the pulse and the gap share, and 0 for an insane duty cycle.  Trains
+    scoring below the threshold of the filter level are dropped.
+
+    A rejected train is passed on as a sample every sample_every rejects,
+    so the decoders can confirm that the filter only drops noise.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_NOISE_FILTER_H_
+#define INCLUDE_NOISE_FILTER_H_
+
+struct pulse_data;
+
+/// Number of width clusters counted as regular, per pulses and gaps.
+#define NOISE_CLUSTERS 4
+
+/// Filter levels, from keeping all trains to dropping all but clean trains.
+enum noise_level {
+  NOISE_LEVEL_OFF          = 0,
+  NOISE_LEVEL_CONSERVATIVE = 1, ///< drop trains with random widths only
+  NOISE_LEVEL_MODERATE     = 2,
+  NOISE_LEVEL_AGGRESSIVE   = 3,
+  NOISE_LEVELS, /**< number of levels, not a level */
+};
+
+typedef struct noise_filter {
+  int level;             ///< enum noise_level
+  unsigned sample_every; ///< pass every nth rejected train as a sample, 0 for none
+
+  /* counters */
+  unsigned rejected; ///< trains dropped as noise, samples included
+  unsigned sampled;  ///< rejected trains passed on as samples
+  unsigned missed;   ///< samples that were decoded, the filter dropped a signal
+} noise_filter_t;
+
+/// Regularity of a train in percent, 100 if all widths fall into a few clusters.
+int noise_score(struct pulse_data const* pulses);
+
+/// Return 0 if the train is noise and should be dropped, 1 to decode it,
+/// 2 to decode a rejected train as a sample.
+int noise_filter_train(noise_filter_t* filter, struct pulse_data const* pulses);
+
+#endif /* INCLUDE_NOISE_FILTER_H_ */
@@ -0,0 +1,82 @@
+/** @file
+    Binary capture container for pulse trains.
+
+    A capture is a header, one record per pulse train and a trailing index:
+
+        header  "RCAP" version(1) flags(1) reserved(2)
+        train   'T' length(varint) payload
+        index   'I' count(varint) offset(u32 LE) * count
+        footer  index offset(u32 LE) "RIDX"
+
+    The train payload holds the flags (bit 0 FSK), the train offset in
+    samples, the sample rate, signal RSSI and duration, the frequencies,
+    the number of pulses and the pulse and gap widths, each as a zigzag
+    varint of the difference to the previous pulse or gap.  Offsets in
+    the index are 32 bit, a capture is limited to 4 GB.
+
+    The writer streams records through a write function and keeps only
+    the record offsets, so it can run on the device.  The reader works
+    on a buffer, e.g. a memory mapped file, and seeks through the index.
+    A capture without index (the writer was not closed) is scanned.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_PULSE_CAPTURE_H_
+#define INCLUDE_PULSE_CAPTURE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct pulse_data;
+
+#define PULSE_CAPTURE_VERSION 1
+
+/// Write len bytes, returns the number of bytes written.
+typedef size_t (*pulse_capture_write_fn)(void const* buf, size_t len, void* ctx);
+
+typedef struct pulse_capture_writer {
+  pulse_capture_write_fn write;
+  void* ctx;
+  uint32_t pos;         ///< bytes written
+  uint32_t* index;      ///< record offsets
+  unsigned num_trains;
+  unsigned index_size;
+  int error;            ///< a write or allocation failed
+} pulse_capture_writer_t;
+
+typedef struct pulse_capture_reader {
+  uint8_t const* data;
+  size_t len;
+  uint8_t const* index; ///< record offsets in the capture, NULL if it has no index
+  uint32_t* offsets;    ///< record offsets found by scanning a capture without index
+  unsigned num_trains;
+} pulse_capture_reader_t;
+
+/// Start a capture, writes the header.
+/// Returns 0 on success, -1 on a write error.
+int pulse_capture_writer_init(pulse_capture_writer_t* writer, pulse_capture_write_fn write, void* ctx);
+
+/// Append a pulse train.
+/// Returns 0 on success, -1 on a write or allocation error.
+int pulse_capture_write(pulse_capture_writer_t* writer, struct pulse_data const* data);
+
+/// Finish a capture, writes the index and frees the writer.
+/// Returns 0 on success, -1 if any write failed.
+int pulse_capture_writer_close(pulse_capture_writer_t* writer);
+
+/// Open a capture in memory, the buffer must stay valid while reading.
+/// Returns 0 on success, -1 if the buffer is not a capture.
+int pulse_capture_reader_init(pulse_capture_reader_t* reader, void const* data, size_t len);
+
+/// Free the reader, not the buffer.
+void pulse_capture_reader_free(pulse_capture_reader_t* reader);
+
+/// Read pulse train n into data.
+/// Returns 0 on success, -1 if n is out of range or the record is corrupt.
+int pulse_capture_read(pulse_capture_reader_t const* reader, unsigned n, struct pulse_data* data);
+
+#endif /* INCLUDE_PULSE_CAPTURE_H_ */
@@ -0,0 +1,69 @@
+/** @file
+    Pulse and gap width classes shared by all slicers.
+
+    A train is clustered once into a few width classes (in the style of the
+    pulse analyzer histograms) so slicers can classify a whole class at once
+    instead of rescanning every raw pulse width for every decoder.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_PULSE_CLASSES_H_
+#define INCLUDE_PULSE_CLASSES_H_
+
+#include <stdint.h>
+
+#include "pulse_data.h"
+
+#define PULSE_CLASSES_MAX 16
+
+/// Relative width tolerance for two widths to fall into the same class.
+#define PULSE_CLASSES_TOLERANCE 0.1f
+
+/// Width class, min and max are the exact range of all member widths.
+typedef struct pulse_class {
+  unsigned count;
+  int sum;
+  int mean; ///< centroid
+  int min;
+  int max;
+} pulse_class_t;
+
+/// Width classes of one pulse train, sorted by mean.
+typedef struct pulse_classes {
+  pulse_data_t const* pulses; ///< train the classes were built for
+  unsigned num_pulses;        ///< number of pulses classified
+  unsigned pulse_count;       ///< number of pulse width classes
+  unsigned gap_count;         ///< number of gap width classes
+  pulse_class_t pulse[PULSE_CLASSES_MAX];
+  pulse_class_t gap[PULSE_CLASSES_MAX];
+  uint8_t pulse_class[PD_MAX_PULSES]; ///< class index of each pulse
+  uint8_t gap_class[PD_MAX_PULSES];   ///< class index of each gap
+} pulse_classes_t;
+
+/// Cluster pulse and gap widths of a train and attach the classes to it.
+void pulse_classes_build(pulse_classes_t* classes, pulse_data_t* pulses);
+
+/// Return the classes of a train, NULL if none were built or they are stale.
+static inline pulse_classes_t const* pulse_classes_get(pulse_data_t const* pulses) {
+  pulse_classes_t const* classes = pulses->classes;
+  if (!classes || classes->pulses != pulses || classes->num_pulses != pulses->num_pulses)
+    return NULL;
+  return classes;
+}
+
+/// Return 1 if no threshold falls into the width range of the class,
+/// i.e. any comparison against the thresholds has the same outcome for all
+/// members and the class can be classified by a single member.
+static inline int pulse_class_uniform(pulse_class_t const* c, int const* thresholds, unsigned num_thresholds) {
+  for (unsigned i = 0; i < num_thresholds; ++i) {
+    if (thresholds[i] >= c->min && thresholds[i] <= c->max)
+      return 0;
+  }
+  return 1;
+}
+
+#endif /* INCLUDE_PULSE_CLASSES_H_ */
@@ -33,6 +33,8 @@
   100 // Pulse width in ms to exceed to declare End Of Package (e.g. for non OOK
       // packages)
 
+struct pulse_classes;
+
 /// Data for a compact representation of generic pulse train.
 typedef struct pulse_data {
   uint64_t offset; ///< Offset to first pulse in number of samples from start of
@@ -62,6 +64,8 @@ typedef struct pulse_data {
   //
   int signalRssi;
   unsigned long signalDuration;
+  struct pulse_classes const *classes; ///< Width classes, see pulse_classes_build().
+  int noiseSample; ///< Rejected by the noise filter and decoded as a sample.
 #ifdef SIGNAL_RSSI
   int rssi[PD_MAX_PULSES];
 #endif
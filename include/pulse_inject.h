@@ -0,0 +1,34 @@
+/** @file
+    Pulse trains from text, for injection into the decoder.
+
+    A text holds one or more trains in any of these forms:
+
+    - OOK text as written by pulse_data_dump(), ";" header lines and
+      "pulse gap" lines in us.  A ";fsk" header marks an FSK train, a
+      ";rssi" header sets the signal RSSI, ";end" or the next header
+      after data ends the train.
+    - An RfRaw line, "AAB0...55" or "rfraw:AAB0...", one train per line.
+    - A pulse string as in the device logs, "+pulse-gap+pulse-gap..." in
+      us, one train per line.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_PULSE_INJECT_H_
+#define INCLUDE_PULSE_INJECT_H_
+
+struct pulse_data;
+
+/// Parse the next train of a text into data, widths in us.
+///
+/// Returns the text after the train, or NULL if the text holds no more trains.
+char const* pulse_inject_parse(struct pulse_data* data, char const* text);
+
+/// Fill in what a captured train carries, a sample rate of 1 MHz and the
+/// signal duration from the widths, where the data has none.
+void pulse_inject_prepare(struct pulse_data* data);
+
+#endif /* INCLUDE_PULSE_INJECT_H_ */
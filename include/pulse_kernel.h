@@ -0,0 +1,39 @@
+/** @file
+    Block classification kernels for the pulse slicers.
+
+    A kernel compares a block of widths against a small set of thresholds
+    and returns one mask per width, bit k is set if the width is greater
+    than threshold k.  Slicer bounds like `x > l && x < u` are expressed as
+    the thresholds `l` and `u - 1` and tested on the mask.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_PULSE_KERNEL_H_
+#define INCLUDE_PULSE_KERNEL_H_
+
+#include <stdint.h>
+
+/// Number of widths slicers classify per kernel call, must be a power of two.
+#define PULSE_KERNEL_BLOCK 32
+
+/// Maximum number of thresholds, one mask bit each.
+#define PULSE_KERNEL_MAX_THRESHOLDS 8
+
+/// Scalar mask of a single width.
+static inline unsigned pulse_kernel_mask(int width, int const* thresholds, unsigned num_thresholds) {
+  unsigned mask = 0;
+  for (unsigned k = 0; k < num_thresholds; ++k)
+    mask |= (unsigned)(width > thresholds[k]) << k;
+  return mask;
+}
+
+/// Classify len widths against up to PULSE_KERNEL_MAX_THRESHOLDS thresholds.
+/// Uses SSE2/AVX2 on hosts that have it and a 2x15-bit SWAR kernel otherwise,
+/// define PULSE_KERNEL_SCALAR to force the scalar kernel.
+void pulse_kernel_gt(int const* widths, unsigned len, int const* thresholds, unsigned num_thresholds, uint8_t* masks);
+
+#endif /* INCLUDE_PULSE_KERNEL_H_ */
@@ -0,0 +1,58 @@
+/** @file
+    Separation of two overlapping OOK transmitters by pulse level.
+
+    When two sensors transmit at once the receiver interleaves their pulses
+    into one train that no decoder accepts.  The pulses of the nearer
+    transmitter are received stronger: two-means clustering of the RSSI of
+    the pulses with a sample splits the train into a weak and a strong
+    level.  Pulses close to the middle or without a sample go to the level
+    whose pulse widths they match best, or with the pulse before them.  Each
+    level then becomes a train of its own, the gaps spanning the pulses of
+    the other level.
+
+    The ring samples once a tick, so most short OOK pulses have no level
+    and are placed by width.  Two sensors of the same type use the same
+    widths, their pulses without a level can not be told apart.
+
+    Needs the per pulse RSSI of SIGNAL_RSSI, see rssi_ring.h.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_PULSE_SEPARATE_H_
+#define INCLUDE_PULSE_SEPARATE_H_
+
+#include <stdint.h>
+
+struct pulse_data;
+
+#if defined(PULSE_SEPARATION) && !defined(SIGNAL_RSSI)
+#  error "PULSE_SEPARATION needs SIGNAL_RSSI"
+#endif
+
+#ifndef PULSE_SEPARATION_DB
+#  define PULSE_SEPARATION_DB 6 ///< least level difference of two transmitters in dB
+#endif
+
+typedef struct pulse_separator {
+  int min_db; ///< least level difference of two transmitters
+
+  /* counters */
+  unsigned split;   ///< trains split into two candidate trains
+  unsigned decoded; ///< splits with at least one candidate decoded
+} pulse_separator_t;
+
+/// Assign every pulse of a train to a level, 0 for the weaker and 1 for
+/// the stronger transmitter.
+///
+/// Returns 1 if the train holds two levels with enough pulses each, else 0.
+int pulse_separate(pulse_separator_t* sep, struct pulse_data const* pulses, uint8_t* level);
+
+/// Build the train of the pulses of one level, with the duration and mean
+/// RSSI of those pulses.
+void pulse_separate_train(struct pulse_data const* pulses, uint8_t const* level, int which, struct pulse_data* out);
+
+#endif /* INCLUDE_PULSE_SEPARATE_H_ */
@@ -158,4 +158,26 @@ int pulse_slicer_osv1(pulse_data_t const *pulses, r_device *device);
 /// @return number of events processed
 int pulse_slicer_string(const char *code, r_device *device);
 
+#ifdef SPECIALIZED_SLICERS
+/// Find the slicer specialized for the modulation and timing of a decoder.
+///
+/// The PWM and PPM decoders in rtl_433_devices.h have slicers with their
+/// timing as constants, see tools/update_pulse_slicer_fixed.sh.
+/// The specialized slicers take 1 sample per us and use the generic
+/// slicer at any other sample rate.
+///
+/// @param device Modulation parameters to match exactly
+/// @return the specialized slicer or NULL if there is none
+int (*pulse_slicer_fixed(r_device const *device))(pulse_data_t const *pulses, r_device *device);
+#endif
+
+#ifdef SHARED_SLICES
+/// Also decode the slices of a decoder with the decoders on its slice_next
+/// list that are not slice_skip, see bitbuffer_view.h.
+///
+/// Only set while all decoders of a train run, a decoder run alone must
+/// not decode for others.
+void pulse_slicer_share_slices(int share);
+#endif
+
 #endif /* INCLUDE_PULSE_SLICER_H_ */
@@ -0,0 +1,129 @@
+/** @file
+    Timings of the specialized pulse slicers.
+
+    This is a generated file from tools/update_pulse_slicer_fixed.sh
+*/
+
+#ifndef INCLUDE_PULSE_SLICER_FIXED_H_
+#define INCLUDE_PULSE_SLICER_FIXED_H_
+
+// SLICER(index, modulation, short_width, long_width, reset_limit, gap_limit, sync_width, tolerance)
+#define PULSE_SLICER_FIXED \
+  SLICER(0, OOK_PULSE_PPM, 1000, 2000, 5000, 3500, 0, 0) /* acurite_rain_896 */ \
+  SLICER(1, OOK_PULSE_PPM, 1000, 2000, 10000, 3000, 0, 0) /* acurite_th */ \
+  SLICER(2, OOK_PULSE_PWM, 220, 408, 4000, 500, 620, 0) /* acurite_txr */ \
+  SLICER(3, OOK_PULSE_PPM, 520, 880, 4000, 1280, 0, 0) /* acurite_986 */ \
+  SLICER(4, OOK_PULSE_PPM, 2000, 4000, 10000, 7000, 0, 0) /* acurite_606 alectov1 prologue thermopro_tx2 */ \
+  SLICER(5, OOK_PULSE_PWM, 232, 420, 708, 520, 632, 0) /* acurite_00275rm */ \
+  SLICER(6, OOK_PULSE_PPM, 500, 1500, 3000, 1484, 500, 0) /* acurite_590tx */ \
+  SLICER(7, OOK_PULSE_PWM, 840, 2070, 6000, 3000, 6600, 0) /* acurite_01185m */ \
+  SLICER(8, OOK_PULSE_PWM, 316, 1020, 1800, 0, 0, 80) /* akhan_100F14 */ \
+  SLICER(9, OOK_PULSE_PPM, 2000, 4000, 8000, 6500, 0, 0) /* ambientweather_tx8300 */ \
+  SLICER(10, OOK_PULSE_PPM, 1000, 2000, 4000, 2500, 2500, 0) /* auriol_4ld5661 */ \
+  SLICER(11, OOK_PULSE_PPM, 500, 920, 2275, 1104, 0, 0) /* auriol_aft77b2 */ \
+  SLICER(12, OOK_PULSE_PPM, 576, 1536, 3954, 2012, 0, 0) /* auriol_afw2a1 */ \
+  SLICER(13, OOK_PULSE_PPM, 2100, 4150, 9150, 4248, 0, 0) /* auriol_ahfl */ \
+  SLICER(14, OOK_PULSE_PWM, 252, 612, 62990, 750, 860, 0) /* auriol_hg02832 */ \
+  SLICER(15, OOK_PULSE_PPM, 1000, 2000, 5000, 3000, 0, 0) /* baldr_rain nexus */ \
+  SLICER(16, OOK_PULSE_PWM, 500, 1500, 8000, 2500, 0, 0) /* blyss */ \
+  SLICER(17, OOK_PULSE_PWM, 320, 968, 4000, 1500, 0, 0) /* brennenstuhl_rcs_2044 */ \
+  SLICER(18, OOK_PULSE_PWM, 250, 500, 1250, 625, 750, 0) /* bresser_3ch */ \
+  SLICER(19, OOK_PULSE_PPM, 1940, 3900, 8800, 4100, 0, 0) /* bt_rain */ \
+  SLICER(20, OOK_PULSE_PWM, 240, 484, 848, 0, 840, 0) /* burnhardbbq */ \
+  SLICER(21, OOK_PULSE_PWM, 760, 2240, 3200, 0, 1560, 0) /* calibeur_RF104 */ \
+  SLICER(22, OOK_PULSE_PWM, 730, 1400, 32000, 1600, 6150, 0) /* cardin */ \
+  SLICER(23, OOK_PULSE_PWM, 568, 1704, 1800, 0, 0, 160) /* chuango */ \
+  SLICER(24, OOK_PULSE_PWM, 732, 2196, 8000, 4000, 1464, 0) /* companion_wtr001 */ \
+  SLICER(25, OOK_PULSE_PPM, 520, 1000, 3000, 0, 0, 0) /* digitech_xc0324 */ \
+  SLICER(26, OOK_PULSE_PPM, 1692, 2812, 9000, 4500, 0, 0) /* dish_remote_6_3 */ \
+  SLICER(27, OOK_PULSE_PWM, 500, 1480, 2000, 1500, 0, 0) /* ecowitt */ \
+  SLICER(28, FSK_PULSE_PWM, 64, 136, 400, 200, 500, 0) /* efergy_e2_classic */ \
+  SLICER(29, FSK_PULSE_PWM, 64, 136, 400, 0, 500, 0) /* efergy_optical */ \
+  SLICER(30, OOK_PULSE_PWM, 250, 500, 5500, 900, 750, 0) /* eurochron_efth800 */ \
+  SLICER(31, OOK_PULSE_PWM, 456, 1448, 8000, 2000, 0, 0) /* elro_db286a */ \
+  SLICER(32, OOK_PULSE_PPM, 500, 1000, 30000, 7250, 0, 0) /* elv_em1000 */ \
+  SLICER(33, OOK_PULSE_PWM, 366, 854, 1000, 0, 0, 0) /* elv_ws2000 */ \
+  SLICER(34, OOK_PULSE_PWM, 280, 796, 850, 3000, 1836, 0) /* emos_e6016 */ \
+  SLICER(35, OOK_PULSE_PWM, 300, 800, 2500, 1000, 0, 0) /* emos_e6016_rain */ \
+  SLICER(36, OOK_PULSE_PPM, 2000, 4000, 9400, 4400, 0, 0) /* esperanza_ews kedsum */ \
+  SLICER(37, OOK_PULSE_PPM, 1016, 2024, 8200, 2100, 0, 0) /* eurochron */ \
+  SLICER(38, OOK_PULSE_PWM, 500, 1500, 1200, 0, 0, 160) /* fineoffset_WH2 */ \
+  SLICER(39, OOK_PULSE_PWM, 504, 1480, 1200, 0, 0, 160) /* fineoffset_WH0530 */ \
+  SLICER(40, OOK_PULSE_PWM, 544, 1524, 10520, 0, 0, 0) /* fineoffset_wh1050 */ \
+  SLICER(41, OOK_PULSE_PWM, 544, 1524, 2800, 0, 0, 0) /* fineoffset_wh1080 */ \
+  SLICER(42, OOK_PULSE_PWM, 400, 600, 9000, 0, 0, 0) /* fs20 */ \
+  SLICER(43, OOK_PULSE_PPM, 1956, 3900, 4000, 4000, 0, 0) /* ft004b */ \
+  SLICER(44, OOK_PULSE_PPM, 536, 1668, 2000, 0, 0, 0) /* gasmate_ba1008 */ \
+  SLICER(45, OOK_PULSE_PWM, 250, 500, 1700, 625, 750, 0) /* geevon */ \
+  SLICER(46, OOK_PULSE_PWM, 888, (1332 + 1784) / 2, 2724 * 1.5, 1200, 1784 + 670, 0) /* generic_motion */ \
+  SLICER(47, OOK_PULSE_PWM, 464, 1404, 1800, 0, 0, 200) /* generic_remote */ \
+  SLICER(48, OOK_PULSE_PPM, 2000, 4000, 10000, 4800, 0, 0) /* generic_temperature_sensor kw9015b */ \
+  SLICER(49, OOK_PULSE_PWM, 440, 940, 9000, 900, 0, 0) /* govee govee_h5054 */ \
+  SLICER(50, OOK_PULSE_PPM, 2000, 4000, 9100, 4200, 0, 0) /* gt_tmbbq05 */ \
+  SLICER(51, OOK_PULSE_PPM, 2500, 5000, 12000, 8000, 0, 0) /* gt_wt_02 */ \
+  SLICER(52, OOK_PULSE_PWM, 256, 625, 61000, 1000, 855, 0) /* gt_wt_03 */ \
+  SLICER(53, OOK_PULSE_PWM, 370, 772, 9000, 1500, 0, 152) /* hcs200 */ \
+  SLICER(54, FSK_PULSE_PWM, 370, 772, 9000, 1500, 0, 152) /* hcs200_fsk */ \
+  SLICER(55, FSK_PULSE_PWM, 488, 976, 6000, 2000, 0, 0) /* holman_ws5029pwm */ \
+  SLICER(56, FSK_PULSE_PWM, 250, 500, 2000, 0, 0, 0) /* hondaremote */ \
+  SLICER(57, OOK_PULSE_PWM, 175, 340, 5000, 0, 500, 0) /* honeywell_wdb */ \
+  SLICER(58, FSK_PULSE_PWM, 160, 320, 560, 0, 500, 0) /* honeywell_wdb_fsk */ \
+  SLICER(59, OOK_PULSE_PWM, 200, 600, 14000, 1200, 0, 0) /* ht680 */ \
+  SLICER(60, OOK_PULSE_PPM, 2000, 4000, 5000, 0, 500, 750) /* infactory */ \
+  SLICER(61, OOK_PULSE_PPM, 122, 244, 500, 0, 0, 0) /* interlogix */ \
+  SLICER(62, OOK_PULSE_PPM, 330, 1400, 10000, 1700, 0, 0) /* intertechno */ \
+  SLICER(63, OOK_PULSE_PWM, 420, 960, 9900, 1100, 0, 160) /* kerui */ \
+  SLICER(64, OOK_PULSE_PWM, 550, 1400, 8000, 3000, 0, 0) /* lacrossetx */ \
+  SLICER(65, OOK_PULSE_PWM, 208, 417, 1700, 625, 833, 0) /* lacrosse_tx141x */ \
+  SLICER(66, OOK_PULSE_PWM, 400, 800, 1100, 0, 0, 0) /* lacrosse_ws7000 */ \
+  SLICER(67, OOK_PULSE_PWM, 368, 1464, 8000, 0, 0, 0) /* lacrossews */ \
+  SLICER(68, OOK_PULSE_PPM, 250, 1250, 1500, 0, 0, 0) /* lightwave_rf */ \
+  SLICER(69, OOK_PULSE_PWM, 368, 704, 2000, 2000, 5628, 0) /* markisol */ \
+  SLICER(70, OOK_PULSE_PPM, 1050, 2050, 4400, 2200, 0, 0) /* maverick_et73 */ \
+  SLICER(71, OOK_PULSE_PPM, 800, 1600, 6000, 2400, 0, 0) /* mebus433 */ \
+  SLICER(72, OOK_PULSE_PPM, 975, 1950, 4500, 2500, 0, 100) /* missil_ml0757 */ \
+  SLICER(73, OOK_PULSE_PPM, 132, 224, 1000, 300, 0, 0) /* new_template */ \
+  SLICER(74, OOK_PULSE_PPM, 300, 1400, 3200, 0, 2650, 200) /* newkaku */ \
+  SLICER(75, OOK_PULSE_PPM, 270, 1300, 2800, 1500, 2650, 200) /* nexa proove */ \
+  SLICER(76, OOK_PULSE_PWM, 500, 1000, 5000, 2000, 1500, 100) /* nice_flor_s */ \
+  SLICER(77, OOK_PULSE_PWM, 544, 932, 31000, 10000, 0, 0) /* opus_xt300 */ \
+  SLICER(78, OOK_PULSE_PPM, 2000, 4000, 10000, 5000, 0, 0) /* oregon_scientific_sl109h rftech */ \
+  SLICER(79, OOK_PULSE_PWM, 2000, 6000, 30000, 0, 0, 0) /* philips_aj3650 */ \
+  SLICER(80, OOK_PULSE_PWM, 2000, 6000, 30000, 0, 1000, 0) /* philips_aj7010 */ \
+  SLICER(81, OOK_PULSE_PWM, 360, 1070, 6600, 1200, 0, 80) /* quhwa */ \
+  SLICER(82, OOK_PULSE_PWM, 580, 976, 14000, 8000, 0, 0) /* regency_fan */ \
+  SLICER(83, OOK_PULSE_PWM, 200, 320, 272, 0, 10024, 0) /* revolt_nc5462 */ \
+  SLICER(84, OOK_PULSE_PPM, 1000, 2000, 4800, 3000, 0, 0) /* rubicson */ \
+  SLICER(85, OOK_PULSE_PPM, 940, 1900, 4000, 2000, 0, 0) /* rubicson_48659 */ \
+  SLICER(86, OOK_PULSE_PWM, 280, 480, 6000, 5000, 730, 0) /* rubicson_pool_48942 */ \
+  SLICER(87, OOK_PULSE_PPM, 1900, 3800, 9400, 4400, 0, 0) /* s3318p wec2103 */ \
+  SLICER(88, OOK_PULSE_PWM, 972, 2680, 2712, 0, 7328, 0) /* schou_72543_rain */ \
+  SLICER(89, FSK_PULSE_PWM, 225, 425, 10000, 2900, 0, 0) /* sharp_spc775 */ \
+  SLICER(90, OOK_PULSE_PWM, 264, 744, 12000, 5000, 0, 0) /* silvercrest */ \
+  SLICER(91, OOK_PULSE_PPM, 600, 1700, 10000, 2000, 0, 0) /* skylink_motion */ \
+  SLICER(92, OOK_PULSE_PWM, 436, 1202, 11764 * 1.2f, 1299 * 1.5f, 0, 0) /* smoke_gs558 */ \
+  SLICER(93, OOK_PULSE_PPM, 972, 1932, 6000, 3000, 0, 0) /* solight_te44 */ \
+  SLICER(94, OOK_PULSE_PPM, 2000, 4000, 9200, 5000, 0, 0) /* springfield */ \
+  SLICER(95, OOK_PULSE_PWM, 235, 480, 850, 0, 836, 0) /* tfa_30_3221 */ \
+  SLICER(96, OOK_PULSE_PWM, 255, 510, 2500, 1300, 750, 0) /* tfa_drop_303233 */ \
+  SLICER(97, OOK_PULSE_PPM, 2000, 4600, 10000, 7800, 0, 0) /* tfa_pool_thermometer */ \
+  SLICER(98, OOK_PULSE_PPM, 2000, 4000, 10000, 6000, 0, 0) /* tfa_twin_plus_303049 */ \
+  SLICER(99, OOK_PULSE_PPM, 500, 1500, 4000, 2000, 0, 0) /* thermopro_tp11 thermopro_tp12 */ \
+  SLICER(100, OOK_PULSE_PPM, 1958, 3825, 8643, 3829, 0, 0) /* thermopro_tx2c */ \
+  SLICER(101, OOK_PULSE_PWM, 680, 2100, 8000, 3000, 1438, 0) /* thermor */ \
+  SLICER(102, OOK_PULSE_PPM, 464, 948, 2000, 1200, 0, 0) /* ts_ft002 */ \
+  SLICER(103, OOK_PULSE_PPM, 2000, 4000, 9500, 5000, 0, 500) /* vauno_en8822c */ \
+  SLICER(104, OOK_PULSE_PWM, 400, 800, 5000, 900, 0, 0) /* visonic_powercode */ \
+  SLICER(105, OOK_PULSE_PWM, 260, 600, 900, 0, 6000, 0) /* watts_thermostat */ \
+  SLICER(106, OOK_PULSE_PWM, 357, 1064, 12000, 1400, 0, 200) /* waveman */ \
+  SLICER(107, OOK_PULSE_PWM, 564, 1476, 2500, 0, 0, 0) /* wg_pb12v1 */ \
+  SLICER(108, OOK_PULSE_PWM, 500, 1000, 4000, 750, 0, 0) /* ws2032 */ \
+  SLICER(109, OOK_PULSE_PPM, 1000, 2000, 4400, 2400, 0, 0) /* wssensor */ \
+  SLICER(110, OOK_PULSE_PWM, 680, 1850, 30000, 4000, 10000, 0) /* wt1024 */ \
+  SLICER(111, OOK_PULSE_PPM, 562, 1687, 6000, 2200, 0, 0) /* X10_RF x10_sec */ \
+  SLICER(112, OOK_PULSE_PWM, 850, 1460, 1500, 0, 5380, 0) /* yale_hsa */ \
+  /* end of list */
+
+#define PULSE_SLICER_FIXED_COUNT 113
+
+#endif /* INCLUDE_PULSE_SLICER_FIXED_H_ */
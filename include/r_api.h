@@ -51,6 +51,10 @@ char const **well_known_output_fields(struct r_cfg *cfg);
 
 char const **determine_csv_fields(struct r_cfg *cfg, char const *const *well_known, int *num_fields);
 
+int run_ook_demod(struct r_device *r_dev, struct pulse_data *pulse_data);
+
+int run_fsk_demod(struct r_device *r_dev, struct pulse_data *fsk_pulse_data);
+
 int run_ook_demods(struct list *r_devs, struct pulse_data *pulse_data);
 
 int run_fsk_demods(struct list *r_devs, struct pulse_data *fsk_pulse_data);
@@ -65,6 +69,9 @@ void log_device_handler(struct r_device *r_dev, int level, struct data *data);
 
 void data_acquired_handler(struct r_device *r_dev, struct data *data);
 
+/// Encode a message and pass it to the message callback, does not free data.
+void r_output_message(struct r_cfg *cfg, struct data *data);
+
 struct data *create_report_data(struct r_cfg *cfg, int level);
 
 void flush_report_data(struct r_cfg *cfg);
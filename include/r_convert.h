@@ -0,0 +1,49 @@
+/** @file
+    Unit conversion plans of the decoders.
+
+    The unit of a field is the suffix of its declared name, e.g.
+    temperature_F or wind_avg_mi_h.  When a decoder is registered the
+    declared fields are matched once against the conversions of the
+    conversion mode, the plan lists the fields to convert with their new
+    names.  Messages are converted by the plan without suffix matching,
+    keys and formats are rewritten in place where the new text fits.
+
+    Fields that are not declared in r_device fields are not converted.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_R_CONVERT_H_
+#define INCLUDE_R_CONVERT_H_
+
+struct r_device;
+struct data;
+
+/// A declared field to convert.
+typedef struct r_convert_field {
+  char const* key;     ///< declared name, from r_device fields
+  char* new_key;       ///< name after the conversion
+  unsigned conversion; ///< index into the conversion table
+} r_convert_field_t;
+
+typedef struct r_convert {
+  int mode;       ///< conversion_mode_t the plan was made for
+  unsigned count; ///< fields to convert
+  r_convert_field_t fields[];
+} r_convert_t;
+
+/// Make the plan of a decoder for a conversion mode.
+/// Plans without fields are shared and must not be freed.
+r_convert_t* r_convert_plan(struct r_device const* r_dev, int mode);
+
+/// Free a plan made by r_convert_plan().
+void r_convert_free(r_convert_t* plan);
+
+/// Convert the fields of a message by the plan of its decoder.
+/// The plan is made again if the conversion mode changed.
+void r_convert_data(struct r_device* r_dev, int mode, struct data* data);
+
+#endif /* INCLUDE_R_CONVERT_H_ */
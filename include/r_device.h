@@ -53,6 +53,7 @@ enum decode_return_codes {
 
 struct bitbuffer;
 struct data;
+struct pulse_data;
 
 /** Device protocol decoder struct. */
 typedef struct r_device {
@@ -84,10 +85,24 @@ typedef struct r_device {
     unsigned decode_ok;
     unsigned decode_messages;
     unsigned decode_fails[5];
+    int schedule_tried; ///< run by r_schedule_demod() on the current train, skipped by the full run
+#ifdef DECODER_PROFILE
+    unsigned profile_stack; ///< deepest stack use of a demod run in bytes
+#endif
+#ifdef SPECIALIZED_SLICERS
+    /// slicer specialized for the timing of the decoder, NULL for the generic slicer
+    int (*slicer_fn)(struct pulse_data const *pulses, struct r_device *device);
+#endif
+#ifdef SHARED_SLICES
+    struct r_device *slice_next; ///< next decoder sharing the slices of this one, see bitbuffer_view.h
+    int slice_follower;          ///< decoded with the slices of an earlier decoder
+    int slice_skip;              ///< filtered out for the current train
+#endif
 
     /* private for flex decoder and output callback */
     void *decode_ctx;
     void *output_ctx;
+    struct r_convert *convert; ///< unit conversion plan of the fields, see r_convert.h
 } r_device;
 
 #endif /* INCLUDE_R_DEVICE_H_ */
@@ -0,0 +1,100 @@
+/** @file
+    Source-side message filter for rtl_433_ESP.
+
+    Rules are evaluated as early as possible: protocol rules when the
+    decoders are selected, the RSSI limit before a signal is demodulated
+    and model/id/channel rules before a message is converted and
+    serialized.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_R_FILTER_H_
+#define INCLUDE_R_FILTER_H_
+
+#include <stdint.h>
+
+struct r_cfg;
+struct r_device;
+struct data;
+
+#ifndef FILTER_MAX_RULES
+#  define FILTER_MAX_RULES 16
+#endif
+
+/// Disabled minimum RSSI.
+#define FILTER_NO_MIN_RSSI (-32768)
+
+typedef enum {
+  FILTER_PROTOCOL,
+  FILTER_MODEL,
+  FILTER_ID,
+  FILTER_CHANNEL,
+  FILTER_KEYS, /**< number of keys, not a key */
+} filter_key_t;
+
+typedef struct filter_rule {
+  filter_key_t key;
+  int deny;     ///< 1 drops matching messages, 0 only lets matching messages pass
+  int numeric;  ///< value is a valid number
+  int num;      ///< numeric value
+  char* str;    ///< value as given, allocated as decoder names can be long
+} filter_rule_t;
+
+typedef struct r_filter {
+  filter_rule_t rules[FILTER_MAX_RULES];
+  unsigned num_rules;
+  unsigned allow_keys; ///< bit mask of keys that have allow rules
+  int min_rssi;        ///< signals below are dropped, FILTER_NO_MIN_RSSI to disable
+
+  uint8_t* skip;    ///< per protocol_num, decoder is not run
+  unsigned num_skip;
+
+  /* counters */
+  unsigned signals_filtered;  ///< signals dropped by the RSSI limit
+  unsigned messages_filtered; ///< messages dropped by model/id/channel rules
+  unsigned decoders_skipped;  ///< decoder runs avoided by protocol rules
+} r_filter_t;
+
+/// Add a rule "[!]key=value", key is one of protocol, model, id or channel.
+/// A leading '!' denies matching messages, otherwise only matching messages pass.
+/// Returns 0 on success, -1 if the rule is invalid or the table is full.
+int r_filter_add(struct r_cfg* cfg, char const* rule);
+
+/// Drop signals with an RSSI below min_rssi, FILTER_NO_MIN_RSSI to disable.
+void r_filter_set_min_rssi(struct r_cfg* cfg, int min_rssi);
+
+/// Remove all rules and the RSSI limit, counters are kept.
+void r_filter_clear(struct r_cfg* cfg);
+
+/// Free the filter, the configuration has no filter afterwards.
+void r_filter_free(struct r_cfg* cfg);
+
+/// Recompute the protocol skip table, call after the registered decoders change.
+void r_filter_update(struct r_cfg* cfg);
+
+/// Return 0 if the protocol rules remove the decoder, without counting.
+static inline int r_filter_decoder_enabled(r_filter_t const* filter, unsigned protocol_num) {
+  return !filter || protocol_num >= filter->num_skip || !filter->skip[protocol_num];
+}
+
+/// Return 0 if the decoder should not be run, counted as a skipped run.
+static inline int r_filter_decoder(r_filter_t* filter, unsigned protocol_num) {
+  if (r_filter_decoder_enabled(filter, protocol_num))
+    return 1;
+  filter->decoders_skipped++;
+  return 0;
+}
+
+/// Return 0 if a signal with this RSSI should be dropped before decoding.
+/// Safe to call from another task while the rules change: the filter is
+/// never freed once made and only the min_rssi int is read.
+int r_filter_signal(struct r_cfg* cfg, int rssi);
+
+/// Return 0 if the message should be dropped before any output work.
+int r_filter_data(struct r_cfg* cfg, struct data* data);
+
+#endif /* INCLUDE_R_FILTER_H_ */
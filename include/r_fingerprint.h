@@ -0,0 +1,59 @@
+/** @file
+    Fingerprint cache of recently decoded pulse trains.
+
+    Sensors repeat the same frame within a burst and every 30-60 seconds.
+    A train is fingerprinted from its width classes (class sequence and
+    quantized class widths, not raw widths) and the decoders that succeeded
+    on a train with the same fingerprint are tried first, the full decoder
+    run is only needed on a miss.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_R_FINGERPRINT_H_
+#define INCLUDE_R_FINGERPRINT_H_
+
+#include <stdint.h>
+
+struct r_device;
+struct list;
+struct pulse_data;
+
+#ifndef FP_CACHE_SIZE
+#  define FP_CACHE_SIZE 16
+#endif
+
+/// Decoders remembered per fingerprint, all decoders with events on the train.
+#define FP_CACHE_DECODERS 4
+
+typedef struct fp_entry {
+  uint32_t fingerprint; ///< 0 for an unused entry
+  uint32_t last_used;
+  unsigned num_decoders;
+  struct r_device* decoders[FP_CACHE_DECODERS];
+} fp_entry_t;
+
+typedef struct fp_cache {
+  fp_entry_t entries[FP_CACHE_SIZE];
+  uint32_t clock;
+  unsigned* decode_ok; ///< decode_ok of each decoder before a full run
+  unsigned num_decode_ok;
+
+  /* counters */
+  unsigned hits;   ///< trains decoded by the cached decoders
+  unsigned misses; ///< trains without a cached fingerprint
+  unsigned stale;  ///< cached decoders found nothing, the full run was needed
+} fp_cache_t;
+
+/// Fingerprint of a train from its width classes, 0 if the train has no classes.
+uint32_t fp_fingerprint(struct pulse_data const* pulses);
+
+/// Run the cached decoders for the train or all decoders on a miss,
+/// fsk selects run_fsk_demods() over run_ook_demods().
+/// Returns the number of events.
+int fp_cache_demod(fp_cache_t* cache, struct list* r_devs, struct pulse_data* pulses, int fsk);
+
+#endif /* INCLUDE_R_FINGERPRINT_H_ */
@@ -0,0 +1,85 @@
+/** @file
+    Transmission schedule learner of known devices.
+
+    Most sensors transmit at a fixed period, 30, 48 or 60 seconds.  The
+    period of each (protocol, id) is learned from the decoded messages,
+    repeats within a burst are one transmission.  When a train arrives
+    within the window of one of the next SCHEDULE_PREDICT transmissions,
+    or within the burst of a recent one, the decoders of those devices are
+    tried first.  The wider windows after longer silences are only used to
+    learn the period.
+
+    A transmission that did not arrive within its window is counted as
+    missed, the missed share of a device is its packet loss.  After a
+    silence of more than SCHEDULE_MAX_GAP periods or repeated off-period
+    intervals the period is learned again.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_R_SCHEDULE_H_
+#define INCLUDE_R_SCHEDULE_H_
+
+#include <stdint.h>
+
+struct r_device;
+struct pulse_data;
+struct data;
+
+#ifndef SCHEDULE_SIZE
+#  define SCHEDULE_SIZE 16
+#endif
+
+#define SCHEDULE_ID_LEN   16
+#define SCHEDULE_BURST_MS 3000 ///< messages closer than this are one transmission
+#define SCHEDULE_JITTER_MS 500 ///< window around an expected transmission, plus 1/32 period
+#define SCHEDULE_MAX_GAP  16   ///< longer silences restart learning
+#define SCHEDULE_PREDICT  2    ///< transmissions ahead the decoders are tried first
+
+typedef struct sched_entry {
+  struct r_device* decoder; ///< NULL for an unused entry
+  char id[SCHEDULE_ID_LEN];
+  uint32_t last;     ///< ms of the last transmission
+  uint32_t period;   ///< learned period in ms, 0 while learning
+  uint32_t interval; ///< previous interval while learning
+  unsigned received; ///< transmissions received
+  unsigned missed;   ///< expected transmissions missed
+  unsigned mismatches;
+} sched_entry_t;
+
+typedef struct r_schedule {
+  sched_entry_t entries[SCHEDULE_SIZE];
+  uint32_t now; ///< ms of the train being decoded
+  struct r_device* tried[SCHEDULE_SIZE]; ///< decoders run on the current train
+  unsigned num_tried;
+
+  /* counters */
+  unsigned hits;   ///< trains decoded by the expected decoders
+  unsigned misses; ///< expected decoders found nothing, the full run was needed
+} r_schedule_t;
+
+/// Run the decoders of the devices expected at now, now is in ms.
+/// Returns the number of events, 0 if nothing was expected or decoded.
+/// The decoders run are marked schedule_tried, the full run skips them
+/// until r_schedule_end().
+int r_schedule_demod(r_schedule_t* schedule, struct pulse_data* pulses, int fsk, uint32_t now);
+
+/// Clear the marks of r_schedule_demod() after the full run of the train.
+void r_schedule_end(r_schedule_t* schedule);
+
+/// Learn from a decoded message of the train decoded last.
+void r_schedule_message(r_schedule_t* schedule, struct r_device* decoder, struct data* data);
+
+/// Missed transmissions of an entry, including those overdue at now.
+unsigned r_schedule_missed(sched_entry_t const* entry, uint32_t now);
+
+/// Number of devices with a learned period.
+unsigned r_schedule_learned(r_schedule_t const* schedule);
+
+/// Health message of entry index, NULL if the entry is unused.
+struct data* r_schedule_data(r_schedule_t const* schedule, unsigned index, uint32_t now);
+
+#endif /* INCLUDE_R_SCHEDULE_H_ */
@@ -14,11 +14,22 @@
 
 #include "pulse_detect.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 /// Check if a given string is in RfRaw format.
 bool rfraw_check(char const *p);
 
-/// Decode RfRaw string to pulse data.
+/// Decode RfRaw string to pulse data, the pulses are appended.
 bool rfraw_parse(pulse_data_t *data, char const *p);
 
+/// Encode pulse data as RfRaw B0 string, with snprintf() semantics.
+///
+/// Widths are clustered into at most 8 buckets, segments end after gaps of
+/// the longest bucket and identical segments are folded into repeats.
+/// Returns the length of the full string, a size of 0 only measures it.
+int rfraw_encode(pulse_data_t const *data, char *buf, size_t size);
+
+/// Decode a pulse string, "+pulse-gap..." widths in us, the pulses are appended.
+bool pulse_str_parse(pulse_data_t *data, char const *p);
+
 #endif /* INCLUDE_RFRAW_H_ */
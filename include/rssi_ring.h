@@ -0,0 +1,50 @@
+/** @file
+    Ring of timed RSSI samples for the RSSI of each pulse.
+
+    The RSSI can only be read over SPI, not in the edge interrupt, so the
+    interrupt stores the last level the receiver task read, up to a tick
+    old at the edge and sampled at an unknown place of the pulse.  The
+    receiver task also pushes each sample with its time and the state of
+    the data pin into this ring.  At the end of a signal every pulse gets
+    the level of the samples taken during it while the pin was high,
+    interpolated at its middle.  Samples of gaps are the noise floor or
+    another transmitter and are not used, a pulse without a sample gets
+    RSSI_RING_NONE.  At one sample a tick ( 1 ms ) that is most short OOK
+    pulses, mostly long pulses and preambles get a level.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_RSSI_RING_H_
+#define INCLUDE_RSSI_RING_H_
+
+#include <stdint.h>
+
+struct pulse_data;
+
+#ifndef RSSI_RING_SIZE
+#  define RSSI_RING_SIZE 256 ///< samples kept, a power of 2, at one sample a tick the last 256 ms
+#endif
+
+#define RSSI_RING_NONE (-32768) ///< RSSI of a pulse without a sample
+
+typedef struct rssi_ring {
+  uint32_t time[RSSI_RING_SIZE]; ///< micros() of the sample
+  int16_t rssi[RSSI_RING_SIZE];
+  uint8_t high[RSSI_RING_SIZE];  ///< data pin high, the sample is of a pulse
+  unsigned head; ///< samples pushed, the next is stored at head % RSSI_RING_SIZE
+} rssi_ring_t;
+
+/// Store a sample, the oldest is overwritten.
+void rssi_ring_push(rssi_ring_t* ring, uint32_t time_us, int rssi, int high);
+
+/// Set the RSSI of the first num_pulses pulses to the level at their
+/// middle from the samples taken during each pulse while the pin was high,
+/// for a train with widths in us that started at start_us.  Pulses without
+/// such a sample get RSSI_RING_NONE.
+void rssi_ring_apply(rssi_ring_t const* ring, struct pulse_data* pulses, unsigned num_pulses, uint32_t start_us);
+
+#endif /* INCLUDE_RSSI_RING_H_ */
@@ -28,8 +28,14 @@
 
 struct sdr_dev;
 struct r_device;
+struct r_filter;
+struct r_schedule;
 struct mg_mgr;
 
+/// Message encodings of r_cfg_t typed_callback.
+#define R_ENCODING_JSON 0
+#define R_ENCODING_CBOR 1
+
 typedef enum {
   CONVERT_NATIVE,
   CONVERT_SI,
@@ -144,6 +150,26 @@ typedef struct r_cfg {
    * publishing.
    */
   void (*callback)(char *message);
+  /**
+   * callback receiving the message in the selected encoding and its length,
+   * used instead of callback when set.
+   */
+  void (*typed_callback)(uint8_t const *message, size_t length, int encoding);
+  int encoding; ///< R_ENCODING_JSON or R_ENCODING_CBOR, for typed_callback
+  /**
+   * Message filter, NULL if no filter was ever configured.
+   */
+  struct r_filter *filter;
+  /**
+   * Transmission schedule learner, NULL if not enabled.
+   */
+  struct r_schedule *schedule;
+  /**
+   * Stack pointer of the decoder task before decoding, DECODER_PROFILE
+   * counts the stack of each decoder from here, NULL to count from the
+   * decoder call.
+   */
+  void *profile_top;
 } r_cfg_t;
 
 #endif /* INCLUDE_RTL_433_H_ */
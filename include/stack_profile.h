@@ -0,0 +1,36 @@
+/** @file
+    Stack painting to measure the stack depth of the decoders.
+
+    The stack below the caller is painted with a fill byte before a
+    decoder runs, afterwards the deepest byte that lost the fill is the
+    deepest stack use of the decoder.  The fill is the FreeRTOS stack fill
+    byte, so painting also resets the task high water mark, afterwards it
+    covers only the decoders run since the last paint.  A guard below the stack
+    pointer is left unpainted, interrupt frames are pushed there while the
+    stack is painted.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_STACK_PROFILE_H_
+#define INCLUDE_STACK_PROFILE_H_
+
+#include <stdint.h>
+
+#define STACK_PROFILE_FILL  0xa5 ///< tskSTACK_FILL_BYTE
+#define STACK_PROFILE_GUARD 512  ///< bytes below the stack pointer left unpainted
+#define STACK_PROFILE_ALIGN 512  ///< recommended stack sizes are rounded up to this
+
+/// Paint the stack from lo up to hi.
+void stack_profile_paint(uint8_t* lo, uint8_t* hi);
+
+/// Bytes used below hi since it was painted, 0 if the fill is intact.
+unsigned stack_profile_depth(uint8_t const* lo, uint8_t const* hi);
+
+/// Recommended task stack size, base + depth * scale + reserve, rounded up.
+unsigned stack_profile_recommend(unsigned base, unsigned depth, float scale, unsigned reserve);
+
+#endif /* INCLUDE_STACK_PROFILE_H_ */
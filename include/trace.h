@@ -0,0 +1,88 @@
+/** @file
+    Binary event trace ring for the capture and decode pipeline.
+
+    Trace points record a timestamp, an event id and a 16 bit argument
+    into a ring of RTL_TRACE_SIZE records, from the interrupt handler,
+    the receiver task, the loop and the decoder task on both cores.  A
+    record costs a few hundred nanoseconds and no serial output, the
+    timing being traced is not changed.  The ring is dumped on demand:
+
+        header  "RTRC" version(1) record size(1) reserved(2) count(u32 LE)
+        record  time(u32 LE, us) event(1) core(1, bit 7 in ISR) arg(u16 LE)
+
+    Records are dumped oldest first.  tools/trace_convert.c converts a
+    dump, also as hex lines in a device log, into a Chrome / Perfetto
+    trace.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#ifndef INCLUDE_TRACE_H_
+#define INCLUDE_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRACE_VERSION     1
+#define TRACE_HEADER_LEN  12
+#define TRACE_RECORD_LEN  8
+#define TRACE_CORE_ISR    0x80
+
+/// Trace events, _BEGIN and _END events are paired per core.
+enum trace_event {
+  TRACE_NONE = 0,
+  TRACE_EDGE_FIRST,     ///< ISR, first edge of a signal, arg pulses
+  TRACE_EDGE,           ///< ISR, accepted edge, arg pulses, with RTL_TRACE_EDGES
+  TRACE_PULSE_WRAP,     ///< ISR, pulse buffer wrapped
+  TRACE_TRAIN_SPLIT,    ///< ISR, train handed over at a long gap, arg pulses
+  TRACE_SIGNAL_START,   ///< receiver task, arg RSSI
+  TRACE_SIGNAL_END,     ///< receiver task, train complete, arg pulses
+  TRACE_SIGNAL_IGNORED, ///< receiver task, signal too short, arg pulses
+  TRACE_TRAIN_COPY,     ///< loop, train copied out of the receive buffer, arg pulses
+  TRACE_TRAIN_QUEUED,   ///< trains waiting in the decoder queue
+  TRACE_TRAIN_DROPPED,  ///< arg enum trace_drop
+  TRACE_DECODE_BEGIN,   ///< decoder task, arg pulses
+  TRACE_DECODE_END,     ///< decoder task, arg events
+  TRACE_DEMOD_BEGIN,    ///< one decoder, arg protocol number
+  TRACE_DEMOD_END,      ///< one decoder, arg events
+  TRACE_CALLBACK_BEGIN, ///< message callback, arg message length
+  TRACE_CALLBACK_END,
+  TRACE_EVENTS, /**< number of events, not an event */
+};
+
+/// Reasons of TRACE_TRAIN_DROPPED.
+enum trace_drop {
+  TRACE_DROP_SHORT = 0, ///< too few pulses
+  TRACE_DROP_RSSI  = 1, ///< below the minimum RSSI filter
+  TRACE_DROP_NOISE = 2, ///< rejected by the noise filter
+  TRACE_DROP_QUEUE = 3, ///< decoder queue full
+};
+
+/// Write len bytes, returns the number of bytes written.
+typedef size_t (*trace_write_fn)(void const* buf, size_t len, void* ctx);
+
+#ifdef RTL_TRACE
+
+/// Ring size in records, a power of 2.
+#  ifndef RTL_TRACE_SIZE
+#    define RTL_TRACE_SIZE 1024
+#  endif
+
+/// Record an event, safe from interrupts and both cores.
+void trace_event(unsigned event, unsigned arg);
+
+/// Write the ring, oldest record first, and clear it.
+/// Recording is paused while the ring is written.
+void trace_dump(trace_write_fn write, void* ctx);
+
+#  define TRACE(event, arg) trace_event((event), (arg))
+#else
+#  define TRACE(event, arg) \
+    do {                    \
+    } while (0)
+#endif
+
+#endif /* INCLUDE_TRACE_H_ */
@@ -0,0 +1,134 @@
+/** @file
+    Receiver parameter autotuner.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "autotune.h"
+
+#include <string.h>
+
+void autotune_init(autotune_t* at, float min_gain, unsigned max_trials) {
+  for (unsigned i = 0; i < at->num_params; ++i)
+    at->params[i].value = at->params[i].best;
+  at->param = 0;
+  at->state = AUTOTUNE_BASELINE;
+  at->moved = 0;
+  at->improved = 0;
+  at->best_score = 0;
+  at->min_gain = min_gain;
+  at->trials = 0;
+  at->max_trials = max_trials;
+}
+
+int autotune_add_param(autotune_t* at, char const* name, float min, float max, float step, float min_step, float value) {
+  if (at->num_params >= AUTOTUNE_MAX_PARAMS)
+    return -1;
+  autotune_param_t* p = &at->params[at->num_params++];
+  p->name = name;
+  p->min = min;
+  p->max = max;
+  p->step = step;
+  p->min_step = min_step;
+  p->value = value;
+  p->best = value;
+  return 0;
+}
+
+float autotune_value(autotune_t const* at, char const* name, float dflt) {
+  for (unsigned i = 0; i < at->num_params; ++i) {
+    if (!strcmp(at->params[i].name, name))
+      return at->params[i].value;
+  }
+  return dflt;
+}
+
+/// Set up a move of the current parameter, returns 0 if it would leave the range.
+static int autotune_move(autotune_t* at, autotune_state_t dir) {
+  autotune_param_t* p = &at->params[at->param];
+  float value = dir == AUTOTUNE_UP ? p->value + p->step : p->value - p->step;
+  if (p->step < p->min_step || value < p->min || value > p->max)
+    return 0;
+  p->value = value;
+  at->state = dir;
+  return 1;
+}
+
+/// Move on to the next parameter that can move, returns 0 when the search is done.
+static int autotune_advance(autotune_t* at) {
+  for (;;) {
+    at->params[at->param].value = at->params[at->param].best;
+    if (++at->param >= at->num_params) {
+      at->param = 0;
+      if (!at->improved) {
+        // no parameter improved in this pass, refine the steps
+        int active = 0;
+        for (unsigned i = 0; i < at->num_params; ++i) {
+          at->params[i].step /= 2;
+          active |= at->params[i].step >= at->params[i].min_step;
+        }
+        if (!active)
+          return 0;
+      }
+      at->improved = 0;
+    }
+    at->moved = 0;
+    if (autotune_move(at, AUTOTUNE_UP) || autotune_move(at, AUTOTUNE_DOWN))
+      return 1;
+  }
+}
+
+int autotune_next(autotune_t* at, float score) {
+  if (at->state == AUTOTUNE_DONE || at->num_params == 0) {
+    at->state = AUTOTUNE_DONE;
+    return 0;
+  }
+  at->trials++;
+
+  if (at->state == AUTOTUNE_BASELINE) {
+    at->best_score = score;
+    at->param = 0;
+    at->moved = 0;
+    at->improved = 0;
+    if (!autotune_move(at, AUTOTUNE_UP) && !autotune_move(at, AUTOTUNE_DOWN) && !autotune_advance(at)) {
+      at->state = AUTOTUNE_DONE;
+      return 0;
+    }
+  } else {
+    autotune_param_t* p = &at->params[at->param];
+    int more;
+    if (score > at->best_score + at->min_gain) {
+      // keep going in the same direction
+      at->best_score = score;
+      p->best = p->value;
+      at->moved = 1;
+      at->improved = 1;
+      more = autotune_move(at, at->state);
+    } else {
+      p->value = p->best;
+      // only turn around if going up never helped
+      more = at->state == AUTOTUNE_UP && !at->moved && autotune_move(at, AUTOTUNE_DOWN);
+    }
+    if (!more && !autotune_advance(at)) {
+      at->state = AUTOTUNE_DONE;
+      return 0;
+    }
+  }
+
+  if (at->max_trials && at->trials >= at->max_trials) {
+    for (unsigned i = 0; i < at->num_params; ++i)
+      at->params[i].value = at->params[i].best;
+    at->state = AUTOTUNE_DONE;
+    return 0;
+  }
+  return 1;
+}
+
+unsigned autotune_run(autotune_t* at, autotune_score_fn score_fn, void* ctx) {
+  while (autotune_next(at, score_fn(at, ctx))) {
+  }
+  return at->trials;
+}
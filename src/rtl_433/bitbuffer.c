@@ -10,6 +10,8 @@
 */
 
 #include "bitbuffer.h"
+#include "bitbuffer_index.h"
+#include "bitbuffer_vote.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -222,6 +224,12 @@ static inline uint8_t bit_at(const uint8_t *bytes, unsigned bit)
 unsigned bitbuffer_search(bitbuffer_t *bitbuffer, unsigned row, unsigned start,
         const uint8_t *pattern, unsigned pattern_bits_len)
 {
+#ifdef SEARCH_INDEX
+    unsigned found;
+    if (bitbuffer_index_search(bitbuffer, row, start, pattern, pattern_bits_len, &found))
+        return found;
+#endif
+
     uint8_t *bits = bitbuffer->bb[row];
     unsigned len  = bitbuffer->bits_per_row[row];
     unsigned ipos = start;
@@ -506,7 +514,12 @@ int bitbuffer_find_repeated_row(bitbuffer_t *bits, unsigned min_repeats, unsigne
             return i;
         }
     }
+#ifdef REPEAT_VOTE
+    // no exact repeats, a majority of at least three rows may still agree
+    return bitbuffer_vote_rows(bits, min_repeats > REPEAT_VOTE_MIN_ROWS ? min_repeats : REPEAT_VOTE_MIN_ROWS, min_bits, NULL);
+#else
     return -1;
+#endif
 }
 
 int bitbuffer_find_repeated_prefix(bitbuffer_t *bits, unsigned min_repeats, unsigned min_bits)
@@ -0,0 +1,247 @@
+/** @file
+    Search index of the patterns decoders look for in shared slices.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "bitbuffer_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bit_util.h"
+#include "bitbuffer_view.h"
+#include "c_util.h"
+
+typedef struct search_pattern {
+  uint64_t bits; ///< MSB first, left aligned
+  unsigned len;
+} search_pattern_t;
+
+typedef struct search_state {
+  uint16_t next[2]; ///< state after a 0 or 1 bit
+  int16_t pattern;  ///< pattern ending here, -1 if none
+  uint16_t output;  ///< longest proper suffix state ending a pattern, 0 if none
+} search_state_t;
+
+typedef struct search_row {
+  int row;            ///< row indexed, -1 if the slot is free
+  int num_patterns;   ///< patterns known when the row was indexed, 0 if it could not be
+  uint16_t first[SEARCH_INDEX_PATTERNS + 1]; ///< hits of pattern p are hits[first[p]] to hits[first[p + 1]]
+} search_row_t;
+
+typedef struct search_index {
+  search_pattern_t pattern[SEARCH_INDEX_PATTERNS];
+  int num_patterns;
+  int built;          ///< patterns in the automaton
+  search_state_t* state;
+
+  unsigned key;       ///< slice and form the rows are indexed for
+  search_row_t rows[SEARCH_INDEX_ROWS];
+  unsigned num_hits;
+  uint16_t hits[SEARCH_INDEX_HITS];
+
+  unsigned answered;
+  unsigned searched;
+} search_index_t;
+
+static R_THREAD_LOCAL search_index_t search;
+
+/// Read len bits of pattern left aligned.
+static uint64_t pattern_bits(uint8_t const* pattern, unsigned len) {
+  uint64_t bits = 0;
+  for (unsigned i = 0; i < (len + 7) / 8; ++i)
+    bits |= (uint64_t)pattern[i] << (56 - 8 * i);
+  if (len < 64)
+    bits &= ~(~(uint64_t)0 >> len);
+  return bits;
+}
+
+/// Index of the pattern, learned if new, -1 if it can not be indexed.
+static int pattern_find(uint8_t const* pattern, unsigned len) {
+  if (len == 0 || len > SEARCH_INDEX_PATTERN_BITS)
+    return -1;
+  uint64_t bits = pattern_bits(pattern, len);
+  for (int i = 0; i < search.num_patterns; ++i) {
+    if (search.pattern[i].len == len && search.pattern[i].bits == bits)
+      return i;
+  }
+  if (search.num_patterns == SEARCH_INDEX_PATTERNS)
+    return -1;
+  search.pattern[search.num_patterns].bits = bits;
+  search.pattern[search.num_patterns].len = len;
+  return search.num_patterns++;
+}
+
+/// Compile the learned patterns into a bitwise Aho-Corasick automaton.
+static int automaton_build(void) {
+  unsigned max_states = 1;
+  for (int i = 0; i < search.num_patterns; ++i)
+    max_states += search.pattern[i].len;
+  search_state_t* state = realloc(search.state, max_states * sizeof(*state));
+  if (!state)
+    return 0;
+  search.state = state;
+  uint16_t* queue = malloc(max_states * sizeof(*queue));
+  uint16_t* fail = calloc(max_states, sizeof(*fail));
+  if (!queue || !fail) {
+    free(queue);
+    free(fail);
+    return 0;
+  }
+
+  // trie of the patterns, 0 marks a missing edge as no edge leads to the root
+  memset(state, 0, max_states * sizeof(*state));
+  state[0].pattern = -1;
+  unsigned num_states = 1;
+  for (int i = 0; i < search.num_patterns; ++i) {
+    unsigned s = 0;
+    for (unsigned b = 0; b < search.pattern[i].len; ++b) {
+      int bit = (search.pattern[i].bits >> (63 - b)) & 1;
+      if (!state[s].next[bit]) {
+        state[num_states].pattern = -1;
+        state[s].next[bit] = num_states++;
+      }
+      s = state[s].next[bit];
+    }
+    state[s].pattern = i;
+  }
+
+  // breadth first the failure links, missing edges then follow them
+  unsigned head = 0, tail = 0;
+  for (int bit = 0; bit < 2; ++bit) {
+    if (state[0].next[bit])
+      queue[tail++] = state[0].next[bit];
+  }
+  while (head < tail) {
+    unsigned u = queue[head++];
+    for (int bit = 0; bit < 2; ++bit) {
+      unsigned v = state[u].next[bit];
+      if (v) {
+        unsigned f = u ? state[fail[u]].next[bit] : 0;
+        fail[v] = f;
+        state[v].output = state[f].pattern >= 0 ? f : state[f].output;
+        queue[tail++] = v;
+      } else {
+        state[u].next[bit] = state[fail[u]].next[bit];
+      }
+    }
+  }
+  free(queue);
+  free(fail);
+
+  search.built = search.num_patterns;
+  return 1;
+}
+
+/// Record every occurrence of every pattern in a row, 0 if they do not fit.
+static int row_build(search_row_t* slot, uint8_t const* bits, unsigned len) {
+  search_state_t const* state = search.state;
+  unsigned count[SEARCH_INDEX_PATTERNS] = {0};
+
+  unsigned s = 0;
+  for (unsigned pos = 0; pos < len; ++pos) {
+    s = state[s].next[bitrow_get_bit(bits, pos)];
+    for (unsigned o = state[s].pattern >= 0 ? s : state[s].output; o; o = state[o].output)
+      count[state[o].pattern]++;
+  }
+
+  unsigned total = search.num_hits;
+  for (int i = 0; i < search.built; ++i) {
+    slot->first[i] = total;
+    total += count[i];
+  }
+  slot->first[search.built] = total;
+  if (total > SEARCH_INDEX_HITS)
+    return 0;
+
+  s = 0;
+  for (unsigned pos = 0; pos < len; ++pos) {
+    s = state[s].next[bitrow_get_bit(bits, pos)];
+    for (unsigned o = state[s].pattern >= 0 ? s : state[s].output; o; o = state[o].output) {
+      int p = state[o].pattern;
+      search.hits[slot->first[p + 1] - count[p]--] = pos + 1 - search.pattern[p].len;
+    }
+  }
+  search.num_hits = total;
+  return 1;
+}
+
+/// The index of a row, NULL if it has none.
+static search_row_t* row_index(bitbuffer_t const* source, unsigned row) {
+  search_row_t* slot = NULL;
+  for (unsigned i = 0; i < SEARCH_INDEX_ROWS; ++i) {
+    if (search.rows[i].row == (int)row)
+      return search.rows[i].num_patterns ? &search.rows[i] : NULL;
+    if (!slot && search.rows[i].row < 0)
+      slot = &search.rows[i];
+  }
+  if (!slot)
+    return NULL;
+
+  slot->row = row;
+  slot->num_patterns = 0;
+  if (search.built != search.num_patterns && !automaton_build())
+    return NULL;
+  if (!row_build(slot, source->bb[row], source->bits_per_row[row]))
+    return NULL;
+  slot->num_patterns = search.built;
+  return slot;
+}
+
+int bitbuffer_index_search(bitbuffer_t const* bitbuffer, unsigned row, unsigned start,
+        uint8_t const* pattern, unsigned pattern_bits_len, unsigned* pos) {
+  unsigned key;
+  bitbuffer_t const* source = bitbuffer_view_source(bitbuffer, &key);
+  if (!source || row >= bitbuffer->num_rows || row >= BITBUF_ROWS
+      || start >= bitbuffer->bits_per_row[row]) {
+    search.searched++;
+    return 0;
+  }
+  unsigned len = bitbuffer->bits_per_row[row];
+  int p = pattern_find(pattern, pattern_bits_len);
+  if (p < 0) {
+    search.searched++;
+    return 0;
+  }
+  // a decoder may have changed the bits of its copy of the slice
+  if (bitbuffer != source && memcmp(bitbuffer->bb[row], source->bb[row], (len + 7) / 8)) {
+    search.searched++;
+    return 0;
+  }
+
+  if (key != search.key) {
+    search.key = key;
+    search.num_hits = 0;
+    for (unsigned i = 0; i < SEARCH_INDEX_ROWS; ++i)
+      search.rows[i].row = -1;
+  }
+  search_row_t const* slot = row_index(source, row);
+  if (!slot || p >= slot->num_patterns) {
+    search.searched++;
+    return 0;
+  }
+
+  // first occurrence at or after start
+  unsigned lo = slot->first[p];
+  unsigned hi = slot->first[p + 1];
+  while (lo < hi) {
+    unsigned mid = (lo + hi) / 2;
+    if (search.hits[mid] < start)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  *pos = lo < slot->first[p + 1] ? search.hits[lo] : len;
+  search.answered++;
+  return 1;
+}
+
+void bitbuffer_index_stats(unsigned* patterns, unsigned* answered, unsigned* searched) {
+  *patterns = search.num_patterns;
+  *answered = search.answered;
+  *searched = search.searched;
+}
@@ -0,0 +1,250 @@
+/** @file
+    Shared slices and their derived forms.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "bitbuffer_view.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c_util.h"
+
+enum view_form {
+  FORM_SLICE,
+  FORM_INVERTED,
+  FORM_NRZS,
+  FORM_NRZM,
+};
+
+typedef struct manchester_memo {
+  int form;           ///< form decoded, -1 for an unused entry
+  uint16_t row;
+  uint16_t start;
+  uint16_t bits;      ///< bits decoded
+  uint16_t end;       ///< position after the decoding
+  uint8_t complete;   ///< ended at an invalid symbol or the row end, not at bits
+  uint8_t bb[SLICE_VIEW_MANCHESTER_BITS / 8];
+} manchester_memo_t;
+
+typedef struct slice_view {
+  bitbuffer_t* bits;      ///< copy handed to the decoders, NULL if no slice is shared
+  size_t slice_extent;
+  bitbuffer_t* derived;   ///< allocated on first use
+  size_t derived_extent;
+  int form;               ///< form in derived, FORM_SLICE if none
+  unsigned generation;    ///< counts the slices and derived forms made
+  unsigned next_memo;
+  manchester_memo_t memo[SLICE_VIEW_MANCHESTER];
+#ifdef SHARED_SLICES
+  bitbuffer_t slice;      ///< the slice as sliced
+#endif
+} slice_view_t;
+
+static R_THREAD_LOCAL slice_view_t view;
+
+#ifdef SHARED_SLICES
+/// Bytes of bb in use, long rows spill into the following rows.
+static size_t bitbuffer_extent(bitbuffer_t const* bits) {
+  size_t extent = 0;
+  for (unsigned row = 0; row < bits->num_rows && row < BITBUF_ROWS; ++row) {
+    size_t end = row * BITBUF_COLS + (bits->bits_per_row[row] + 7) / 8;
+    if (end > extent)
+      extent = end;
+  }
+  return MIN(extent, sizeof(bits->bb));
+}
+#endif
+
+/// Copy src over dst, clearing what dst used beyond src.
+static void bitbuffer_copy(bitbuffer_t* dst, size_t dst_extent, bitbuffer_t const* src, size_t src_extent) {
+  memcpy(dst, src, offsetof(bitbuffer_t, bb));
+  memcpy(dst->bb, src->bb, src_extent);
+  if (dst_extent > src_extent)
+    memset((uint8_t*)dst->bb + src_extent, 0, dst_extent - src_extent);
+}
+
+#ifdef SHARED_SLICES
+static void view_reset(void) {
+  view.form = FORM_SLICE;
+  view.next_memo = 0;
+  for (unsigned i = 0; i < SLICE_VIEW_MANCHESTER; ++i)
+    view.memo[i].form = -1;
+}
+#endif
+
+void bitbuffer_view_begin(bitbuffer_t* bits) {
+#ifdef SHARED_SLICES
+  size_t extent = bitbuffer_extent(bits);
+  bitbuffer_copy(&view.slice, view.slice_extent, bits, extent);
+  view.slice_extent = extent;
+  view.bits = bits;
+  view.generation++;
+  view_reset();
+#else
+  (void)bits;
+#endif
+}
+
+int bitbuffer_view_restore(bitbuffer_t* bits) {
+#ifdef SHARED_SLICES
+  if (bits != view.bits)
+    return 0;
+  bitbuffer_copy(bits, bitbuffer_extent(bits), &view.slice, view.slice_extent);
+  return 1;
+#else
+  (void)bits;
+  return 0;
+#endif
+}
+
+void bitbuffer_view_end(void) {
+  view.bits = NULL;
+}
+
+/// The form of bits if it is a shared slice or its derived form, else -1.
+static int view_form_of(bitbuffer_t const* bits) {
+  if (!view.bits)
+    return -1;
+  if (bits == view.derived && view.form != FORM_SLICE)
+    return view.form;
+#ifdef SHARED_SLICES
+  // a decoder may have changed the rows of its copy before
+  if (bits == view.bits && !memcmp(bits, &view.slice, offsetof(bitbuffer_t, bb)))
+    return FORM_SLICE;
+#endif
+  return -1;
+}
+
+static bitbuffer_t* view_derive(bitbuffer_t* bits, int form, void (*decode)(bitbuffer_t*)) {
+  int from = view_form_of(bits);
+  if (from != FORM_SLICE) {
+    decode(bits);
+    if (from >= 0)
+      view.form = FORM_SLICE; // a derived form derived again is no longer shared
+    return bits;
+  }
+  if (view.form == form)
+    return view.derived;
+  if (!view.derived) {
+    view.derived = calloc(1, sizeof(*view.derived));
+    view.derived_extent = 0;
+    if (!view.derived) {
+      decode(bits); // the copy is restored for the next decoder anyway
+      return bits;
+    }
+  }
+  bitbuffer_copy(view.derived, view.derived_extent, bits, view.slice_extent);
+  view.derived_extent = view.slice_extent;
+  decode(view.derived);
+  view.form = form;
+  view.generation++;
+  return view.derived;
+}
+
+bitbuffer_t const* bitbuffer_view_source(bitbuffer_t const* bits, unsigned* key) {
+  int form = view_form_of(bits);
+  if (form < 0)
+    return NULL;
+  *key = (view.generation << 2 | form) + 1;
+#ifdef SHARED_SLICES
+  if (form == FORM_SLICE)
+    return &view.slice;
+#endif
+  return view.derived;
+}
+
+bitbuffer_t* bitbuffer_view_invert(bitbuffer_t* bits) {
+  return view_derive(bits, FORM_INVERTED, bitbuffer_invert);
+}
+
+bitbuffer_t* bitbuffer_view_nrzs_decode(bitbuffer_t* bits) {
+  return view_derive(bits, FORM_NRZS, bitbuffer_nrzs_decode);
+}
+
+bitbuffer_t* bitbuffer_view_nrzm_decode(bitbuffer_t* bits) {
+  return view_derive(bits, FORM_NRZM, bitbuffer_nrzm_decode);
+}
+
+/// Decode as bitbuffer_manchester_decode() with a max of limit bits into memo.
+static void memo_decode(manchester_memo_t* memo, bitbuffer_t const* inbuf, unsigned row, unsigned start, unsigned limit) {
+  uint8_t const* bits = inbuf->bb[row];
+  unsigned len = inbuf->bits_per_row[row];
+  unsigned ipos = start;
+  unsigned n = 0;
+  int clamped = len > start + limit * 2;
+  if (clamped)
+    len = start + limit * 2;
+
+  memset(memo->bb, 0, sizeof(memo->bb));
+  int complete = 1;
+  while (ipos < len) {
+    uint8_t bit1 = bitrow_get_bit(bits, ipos++);
+    uint8_t bit2 = bitrow_get_bit(bits, ipos++);
+    if (bit1 == bit2)
+      break;
+    if (bit2)
+      memo->bb[n / 8] |= 0x80 >> (n % 8);
+    n++;
+  }
+  if (n == limit && clamped)
+    complete = 0; // stopped at the limit, more may follow
+  memo->row = row;
+  memo->start = start;
+  memo->bits = n;
+  memo->end = ipos;
+  memo->complete = complete;
+}
+
+/// Bits and end position of a request for max bits, 0 if the memo can not serve it.
+static int memo_serve(manchester_memo_t const* memo, unsigned start, unsigned max, unsigned* n, unsigned* end) {
+  if (memo->complete && (max == 0 || max > memo->bits)) {
+    *n = memo->bits;
+    *end = memo->end;
+    return 1;
+  }
+  if (max && max <= memo->bits) {
+    *n = max;
+    *end = start + max * 2;
+    return 1;
+  }
+  return 0;
+}
+
+unsigned bitbuffer_view_manchester_decode(bitbuffer_t* inbuf, unsigned row, unsigned start, bitbuffer_t* outbuf, unsigned max) {
+  int form = view_form_of(inbuf);
+  if (form < 0 || row >= inbuf->num_rows || start > UINT16_MAX)
+    return bitbuffer_manchester_decode(inbuf, row, start, outbuf, max);
+
+  unsigned n = 0;
+  unsigned end = start;
+  manchester_memo_t* memo = NULL;
+  for (unsigned i = 0; i < SLICE_VIEW_MANCHESTER; ++i) {
+    manchester_memo_t* m = &view.memo[i];
+    if (m->form == form && m->row == row && m->start == start) {
+      memo = m;
+      break;
+    }
+  }
+  if (!memo || !memo_serve(memo, start, max, &n, &end)) {
+    if (max == 0 || max > SLICE_VIEW_MANCHESTER_BITS)
+      return bitbuffer_manchester_decode(inbuf, row, start, outbuf, max);
+    if (!memo) {
+      memo = &view.memo[view.next_memo];
+      view.next_memo = (view.next_memo + 1) % SLICE_VIEW_MANCHESTER;
+    }
+    memo->form = form;
+    memo_decode(memo, inbuf, row, start, max);
+    if (!memo_serve(memo, start, max, &n, &end))
+      return bitbuffer_manchester_decode(inbuf, row, start, outbuf, max);
+  }
+
+  for (unsigned i = 0; i < n; ++i)
+    bitbuffer_add_bit(outbuf, bitrow_get_bit(memo->bb, i));
+  return end;
+}
@@ -0,0 +1,110 @@
+/** @file
+    Majority vote of repeated rows.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "bitbuffer_vote.h"
+
+#include <string.h>
+
+#include "c_util.h"
+
+#define VOTE_MAX_BITS (BITBUF_COLS * 8)
+
+/// Bits of row b at shift differing from row a, stops counting above limit.
+static unsigned row_distance(uint8_t const* a, int len_a, uint8_t const* b, int len_b, int shift, unsigned limit) {
+  int from = shift < 0 ? -shift : 0;
+  int to = MIN(len_a, len_b - shift);
+  unsigned dist = 0;
+  for (int i = from; i < to && dist <= limit; ++i)
+    dist += bitrow_get_bit(a, i) != bitrow_get_bit(b, i + shift);
+  return dist;
+}
+
+int bitbuffer_vote_rows(bitbuffer_t* bits, unsigned min_rows, unsigned min_bits, uint8_t* agree) {
+  // the first row of the most common length is the reference
+  int ref = -1;
+  unsigned ref_count = 0;
+  for (int i = 0; i < bits->num_rows; ++i) {
+    unsigned len = bits->bits_per_row[i];
+    if (len < min_bits || len > VOTE_MAX_BITS)
+      continue;
+    unsigned count = 0;
+    for (int j = i; j < bits->num_rows; ++j)
+      count += bits->bits_per_row[j] == len;
+    if (count > ref_count) {
+      ref = i;
+      ref_count = count;
+    }
+  }
+  if (ref < 0)
+    return -1;
+
+  uint8_t const* ref_bits = bits->bb[ref];
+  unsigned len = bits->bits_per_row[ref];
+  int voter[BITBUF_ROWS];
+  int shift[BITBUF_ROWS];
+  unsigned voters = 0;
+  for (int i = 0; i < bits->num_rows; ++i) {
+    unsigned len_i = bits->bits_per_row[i];
+    if (len_i < min_bits || len_i > VOTE_MAX_BITS || len_i + REPEAT_VOTE_SLIP < len || len_i > len + REPEAT_VOTE_SLIP)
+      continue;
+    if (i == ref) {
+      voter[voters] = i;
+      shift[voters++] = 0;
+      continue;
+    }
+    unsigned limit = len / 8;
+    unsigned best = limit + 1;
+    int best_shift = 0;
+    for (int s = -REPEAT_VOTE_SLIP; s <= REPEAT_VOTE_SLIP; ++s) {
+      unsigned dist = row_distance(ref_bits, len, bits->bb[i], len_i, s, limit);
+      if (dist < best) {
+        best = dist;
+        best_shift = s;
+      }
+    }
+    if (best <= limit) {
+      voter[voters] = i;
+      shift[voters++] = best_shift;
+    }
+  }
+  if (voters < min_rows)
+    return -1;
+
+  // room for a new row, the voted bits are kept until all are known
+  int row = bits->bits_per_row[bits->num_rows - 1] == 0 && bits->free_row == bits->num_rows
+          ? bits->num_rows - 1
+          : bits->free_row;
+  if (row >= BITBUF_ROWS)
+    return -1;
+  uint8_t voted[BITBUF_COLS] = {0};
+
+  for (unsigned i = 0; i < len; ++i) {
+    unsigned ones = 0, votes = 0;
+    for (unsigned v = 0; v < voters; ++v) {
+      int pos = (int)i + shift[v];
+      if (pos < 0 || pos >= bits->bits_per_row[voter[v]])
+        continue;
+      votes++;
+      ones += bitrow_get_bit(bits->bb[voter[v]], pos);
+    }
+    if (ones * 2 == votes)
+      return -1; // a tie, or no row has the bit
+    if (ones * 2 > votes)
+      voted[i / 8] |= 0x80 >> (i % 8);
+    if (agree)
+      agree[i] = ones * 2 > votes ? ones : votes - ones;
+  }
+
+  if (row != bits->num_rows - 1)
+    bitbuffer_add_row(bits);
+  memcpy(bits->bb[row], voted, sizeof(voted));
+  bits->bits_per_row[row] = len;
+  bits->syncs_before_row[row] = 0;
+  return row;
+}
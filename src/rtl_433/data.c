@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // Macro to prevent unused variables (passed into a function)
 // from generating a warning.
@@ -594,3 +595,150 @@ R_API size_t data_print_jsons(data_t *data, char *dst, size_t len)
 
     return len - jsons.msg.left;
 }
+
+/* CBOR (RFC 8949) printer */
+
+typedef struct {
+    struct data_output output;
+    unsigned char *tail;
+    size_t left;
+    bool overflow;
+} data_print_cbor_t;
+
+static void cbor_put(data_print_cbor_t *cbor, void const *src, size_t len)
+{
+    if (cbor->left < len) {
+        cbor->overflow = true;
+        return;
+    }
+    memcpy(cbor->tail, src, len);
+    cbor->tail += len;
+    cbor->left -= len;
+}
+
+static void cbor_head(data_print_cbor_t *cbor, unsigned major, uint64_t val)
+{
+    unsigned char buf[9];
+    size_t len;
+    if (val < 24) {
+        buf[0] = (major << 5) | val;
+        len    = 1;
+    }
+    else if (val <= 0xff) {
+        buf[0] = (major << 5) | 24;
+        len    = 2;
+    }
+    else if (val <= 0xffff) {
+        buf[0] = (major << 5) | 25;
+        len    = 3;
+    }
+    else if (val <= 0xffffffff) {
+        buf[0] = (major << 5) | 26;
+        len    = 5;
+    }
+    else {
+        buf[0] = (major << 5) | 27;
+        len    = 9;
+    }
+    for (size_t i = 1; i < len; ++i) {
+        buf[i] = val >> (8 * (len - 1 - i));
+    }
+    cbor_put(cbor, buf, len);
+}
+
+static void R_API_CALLCONV format_cbor_array(data_output_t *output, data_array_t *array, char const *format)
+{
+    data_print_cbor_t *cbor = (data_print_cbor_t *)output;
+
+    cbor_head(cbor, 4, array->num_values);
+    for (int c = 0; c < array->num_values; ++c) {
+        print_array_value(output, array, format, c);
+    }
+}
+
+static void R_API_CALLCONV format_cbor_object(data_output_t *output, data_t *data, char const *format)
+{
+    UNUSED(format);
+    data_print_cbor_t *cbor = (data_print_cbor_t *)output;
+
+    unsigned count = 0;
+    for (data_t *d = data; d; d = d->next) {
+        count++;
+    }
+    cbor_head(cbor, 5, count);
+    while (data) {
+        output->print_string(output, data->key, NULL);
+        print_value(output, data->type, data->value, data->format);
+        data = data->next;
+    }
+}
+
+static void R_API_CALLCONV format_cbor_string(data_output_t *output, const char *str, char const *format)
+{
+    UNUSED(format);
+    data_print_cbor_t *cbor = (data_print_cbor_t *)output;
+
+    size_t str_len = strlen(str);
+    cbor_head(cbor, 3, str_len);
+    cbor_put(cbor, str, str_len);
+}
+
+static void R_API_CALLCONV format_cbor_double(data_output_t *output, double data, char const *format)
+{
+    UNUSED(format);
+    data_print_cbor_t *cbor = (data_print_cbor_t *)output;
+
+    // use single precision if no precision is lost
+    float f = (float)data;
+    unsigned char buf[9];
+    size_t len;
+    if ((double)f == data) {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        buf[0] = 0xfa;
+        len    = 5;
+        for (size_t i = 1; i < len; ++i) {
+            buf[i] = bits >> (8 * (len - 1 - i));
+        }
+    }
+    else {
+        uint64_t bits;
+        memcpy(&bits, &data, sizeof(bits));
+        buf[0] = 0xfb;
+        len    = 9;
+        for (size_t i = 1; i < len; ++i) {
+            buf[i] = bits >> (8 * (len - 1 - i));
+        }
+    }
+    cbor_put(cbor, buf, len);
+}
+
+static void R_API_CALLCONV format_cbor_int(data_output_t *output, int data, char const *format)
+{
+    UNUSED(format);
+    data_print_cbor_t *cbor = (data_print_cbor_t *)output;
+
+    if (data < 0)
+        cbor_head(cbor, 1, -1 - (int64_t)data);
+    else
+        cbor_head(cbor, 0, data);
+}
+
+R_API size_t data_print_cbor(data_t *data, unsigned char *dst, size_t len)
+{
+    data_print_cbor_t cbor = {
+            .output = {
+                    .print_data   = format_cbor_object,
+                    .print_array  = format_cbor_array,
+                    .print_string = format_cbor_string,
+                    .print_double = format_cbor_double,
+                    .print_int    = format_cbor_int,
+            },
+            .tail = dst,
+            .left = len,
+    };
+
+    format_cbor_object(&cbor.output, data, NULL);
+
+    return cbor.overflow ? 0 : len - cbor.left;
+}
@@ -16,6 +16,33 @@
 
 // create decoder functions
 
+r_device *decoder_create(r_device const *dev_template, unsigned user_data_size)
+{
+    r_device *r_dev = calloc(1, sizeof (*r_dev));
+    if (!r_dev) {
+        WARN_MALLOC("decoder_create()");
+        return NULL; // NOTE: returns NULL on alloc failure.
+    }
+    if (dev_template)
+        *r_dev = *dev_template; // copy
+
+    if (user_data_size) {
+        r_dev->decode_ctx = calloc(1, user_data_size);
+        if (!r_dev->decode_ctx) {
+            WARN_MALLOC("decoder_create()");
+            free(r_dev);
+            return NULL; // NOTE: returns NULL on alloc failure.
+        }
+    }
+
+    return r_dev;
+}
+
+void *decoder_user_data(r_device *decoder)
+{
+    return decoder->decode_ctx;
+}
+
 r_device *create_device(r_device const *dev_template)
 {
     r_device *r_dev = malloc(sizeof (*r_dev));
@@ -33,7 +60,16 @@ r_device *create_device(r_device const *dev_template)
 
 void decoder_output_log(r_device *decoder, int level, data_t *data)
 {
-    decoder->log_fn(decoder, level, data);
+    if (decoder->log_fn)
+        decoder->log_fn(decoder, level, data);
+    else
+        data_free(data);
+}
+
+/// Log records are only built if a log output was registered.
+static int decoder_log_enabled(r_device *decoder, int level)
+{
+    return decoder->log_fn && decoder->verbose >= level;
 }
 
 void decoder_output_data(r_device *decoder, data_t *data)
@@ -56,6 +92,11 @@ static char *bitrow_asprint_code(uint8_t const *bitrow, unsigned bit_len)
     // remove last nibble if needed
     row_bytes[2 * (bit_len + 3) / 8] = '\0';
 
+    // print at least one '0'
+    if (bit_len == 0) {
+        snprintf(row_bytes, sizeof(row_bytes), "0");
+    }
+
     // a simple bitrow representation
     row_code = malloc(8 + bit_len / 4 + 1); // "{nnnn}..\0"
     if (!row_code) {
@@ -96,9 +137,14 @@ static char *bitrow_asprint_bits(uint8_t const *bitrow, unsigned bit_len)
 
 // variadic output functions
 
+int decoder_verbose(r_device *decoder)
+{
+    return decoder->verbose;
+}
+
 void decoder_log(r_device *decoder, int level, char const *func, char const *msg)
 {
-    if (decoder->verbose >= level) {
+    if (decoder_log_enabled(decoder, level)) {
         // note that decoder levels start at LOG_WARNING
         level += 4;
 
@@ -113,14 +159,9 @@ void decoder_log(r_device *decoder, int level, char const *func, char const *msg
     }
 }
 
-int decoder_verbose(r_device *decoder)
-{
-    return decoder->verbose;
-}
-
 void decoder_logf(r_device *decoder, int level, char const *func, _Printf_format_string_ const char *format, ...)
 {
-    if (decoder->verbose >= level) {
+    if (decoder_log_enabled(decoder, level)) {
         char msg[60]; // fixed length limit
         va_list ap;
         va_start(ap, format);
@@ -133,14 +174,15 @@ void decoder_logf(r_device *decoder, int level, char const *func, _Printf_format
 
 void decoder_log_bitbuffer(r_device *decoder, int level, char const *func, const bitbuffer_t *bitbuffer, char const *msg)
 {
-    if (decoder->verbose >= level) {
+    if (decoder_log_enabled(decoder, level)) {
         // note that decoder levels start at LOG_WARNING
         level += 4;
 
-        char *row_codes[BITBUF_ROWS];
+        char *row_codes[BITBUF_ROWS] = {0};
         char *row_bits[BITBUF_ROWS] = {0};
 
-        for (unsigned i = 0; i < bitbuffer->num_rows; i++) {
+        unsigned num_rows = bitbuffer->num_rows;
+        for (unsigned i = 0; i < num_rows; i++) {
             row_codes[i] = bitrow_asprint_code(bitbuffer->bb[i], bitbuffer->bits_per_row[i]);
 
             if (decoder->verbose_bits) {
@@ -153,20 +195,18 @@ void decoder_log_bitbuffer(r_device *decoder, int level, char const *func, const
                 "src",     "",     DATA_STRING, func,
                 "lvl",      "",     DATA_INT,    level,
                 "msg",      "",     DATA_STRING, msg,
-                "num_rows", "",     DATA_INT, bitbuffer->num_rows,
-                "codes",    "",     DATA_ARRAY, data_array(bitbuffer->num_rows, DATA_STRING, row_codes),
+                "num_rows", "",     DATA_INT, num_rows,
+                "codes",    "",     DATA_ARRAY, data_array(num_rows, DATA_STRING, row_codes),
                 NULL);
         /* clang-format on */
 
         if (decoder->verbose_bits) {
-            data_append(data,
-                    "bits", "", DATA_ARRAY, data_array(bitbuffer->num_rows, DATA_STRING, row_bits),
-                    NULL);
+            data = data_ary(data, "bits", "", NULL, data_array(num_rows, DATA_STRING, row_bits));
         }
 
         decoder_output_log(decoder, level, data);
 
-        for (unsigned i = 0; i < bitbuffer->num_rows; i++) {
+        for (unsigned i = 0; i < num_rows; i++) {
             free(row_codes[i]);
             free(row_bits[i]);
         }
@@ -176,7 +216,7 @@ void decoder_log_bitbuffer(r_device *decoder, int level, char const *func, const
 void decoder_logf_bitbuffer(r_device *decoder, int level, char const *func, const bitbuffer_t *bitbuffer, _Printf_format_string_ const char *format, ...)
 {
     // TODO: pass to interested outputs
-    if (decoder->verbose >= level) {
+    if (decoder_log_enabled(decoder, level)) {
         char msg[60]; // fixed length limit
         va_list ap;
         va_start(ap, format);
@@ -189,7 +229,7 @@ void decoder_logf_bitbuffer(r_device *decoder, int level, char const *func, cons
 
 void decoder_log_bitrow(r_device *decoder, int level, char const *func, uint8_t const *bitrow, unsigned bit_len, char const *msg)
 {
-    if (decoder->verbose >= level) {
+    if (decoder_log_enabled(decoder, level)) {
         // note that decoder levels start at LOG_WARNING
         level += 4;
 
@@ -209,9 +249,7 @@ void decoder_log_bitrow(r_device *decoder, int level, char const *func, uint8_t
 
         if (decoder->verbose_bits) {
             row_bits = bitrow_asprint_bits(bitrow, bit_len);
-            data_append(data,
-                    "bits", "", DATA_STRING, row_bits,
-                    NULL);
+            data = data_str(data, "bits", "", NULL, row_bits);
         }
 
         decoder_output_log(decoder, level, data);
@@ -223,7 +261,7 @@ void decoder_log_bitrow(r_device *decoder, int level, char const *func, uint8_t
 
 void decoder_logf_bitrow(r_device *decoder, int level, char const *func, uint8_t const *bitrow, unsigned bit_len, _Printf_format_string_ const char *format, ...)
 {
-    if (decoder->verbose >= level) {
+    if (decoder_log_enabled(decoder, level)) {
         char msg[60]; // fixed length limit
         va_list ap;
         va_start(ap, format);
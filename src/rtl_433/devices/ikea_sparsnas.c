@@ -87,7 +87,7 @@ detail. Many thanks to kodarn!
 #define IKEA_SPARSNAS_ID_KEY_SUB 0x5D38E8CB
 
 static uint16_t const ikea_sparsnas_pulses_per_kwh = 1000;
-static uint32_t ikea_sparsnas_sensor_id = 0;
+static R_THREAD_LOCAL uint32_t ikea_sparsnas_sensor_id = 0;
 
 static uint32_t ikea_sparsnas_brute_force_encryption(uint8_t buffer[18])
 {
@@ -134,8 +134,8 @@ static int find_next(bitbuffer_t *bitbuffer, int cur_index)
 // max age for cache in us
 #define CACHE_MAX_AGE 800000
 
-static uint8_t cached_result[24] = {0};
-static struct timeval cached_tv  = {0};
+static R_THREAD_LOCAL uint8_t cached_result[24] = {0};
+static R_THREAD_LOCAL struct timeval cached_tv  = {0};
 
 static int secplus_v1_callback(r_device *decoder, bitbuffer_t *bitbuffer)
 {
@@ -175,6 +175,7 @@ static char const *const output_fields[] = {
         "brand",
         "battery_ok",
         "pressure_kPa",
+        "temperature_C",
         "flags1",
         "flags2",
         "flags3",
@@ -113,6 +113,7 @@ static char const *const output_fields[] = {
         "id",
         "battery_ok",
         "pressure_kPa",
+        "temperature_C",
         "flags1",
         "flags2",
         "flags3",
@@ -42,7 +42,7 @@ static int tpms_citroen_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsign
     int maybe_battery;
     int crc;
 
-    bitbuffer_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 88);
+    bitbuffer_view_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 88);
 
     // decoder_logf(decoder, 3, __func__, "bits %d", packet_bits.bits_per_row[0]);
     if (packet_bits.bits_per_row[0] < 80) {
@@ -103,7 +103,7 @@ static int tpms_citroen_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     int ret         = 0;
     int events      = 0;
 
-    bitbuffer_invert(bitbuffer);
+    bitbuffer = bitbuffer_view_invert(bitbuffer);
 
     // Find a preamble with enough bits after it that it could be a complete packet
     while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, 16)) + 178 <=
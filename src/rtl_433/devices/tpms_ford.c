@@ -67,7 +67,7 @@ static int tpms_ford_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsigned
     int unknown;
     int unknown_3;
 
-    bitbuffer_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 160);
+    bitbuffer_view_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 160);
 
     // require 64 data bits
     if (packet_bits.bits_per_row[0] < 64) {
@@ -192,7 +192,7 @@ static int tpms_ford_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     int ret    = 0;
     int events = 0;
 
-    bitbuffer_invert(bitbuffer);
+    bitbuffer = bitbuffer_view_invert(bitbuffer);
 
     for (row = 0; row < bitbuffer->num_rows; ++row) {
         bitpos = 0;
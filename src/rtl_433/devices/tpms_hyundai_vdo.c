@@ -53,7 +53,7 @@ static int tpms_hyundai_vdo_decode(r_device *decoder, bitbuffer_t *bitbuffer, un
     int maybe_battery;
     int crc;
 
-    bitbuffer_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 80);
+    bitbuffer_view_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 80);
 
     if (packet_bits.bits_per_row[0] < 80) {
         return DECODE_FAIL_SANITY; // too short to be a whole packet
@@ -113,7 +113,7 @@ static int tpms_hyundai_vdo_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     int ret         = 0;
     int events      = 0;
 
-    bitbuffer_invert(bitbuffer);
+    bitbuffer = bitbuffer_view_invert(bitbuffer);
 
     // Find a preamble with enough bits after it that it could be a complete packet
     while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, 32)) + 80 <=
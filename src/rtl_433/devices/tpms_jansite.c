@@ -38,7 +38,7 @@ static int tpms_jansite_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsign
     int pressure;
     int temperature;
 
-    bitbuffer_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 56);
+    bitbuffer_view_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 56);
 
     if (packet_bits.bits_per_row[0] < 56) {
         return DECODE_FAIL_SANITY;
@@ -87,7 +87,7 @@ static int tpms_jansite_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     int ret         = 0;
     int events      = 0;
 
-    bitbuffer_invert(bitbuffer);
+    bitbuffer = bitbuffer_view_invert(bitbuffer);
 
     // Find a preamble with enough bits after it that it could be a complete packet
     while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, 24)) + 80 <=
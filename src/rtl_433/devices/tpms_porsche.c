@@ -106,7 +106,7 @@ static char const *const output_fields[] = {
         "model",
         "type",
         "id",
-        "pressure",
+        "pressure_kPa",
         "temperature_C",
         "flags",
         "mic",
@@ -35,7 +35,7 @@ static int tpms_renault_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsign
     int pressure_raw, temp_c, unknown;
     double pressure_kpa;
 
-    bitbuffer_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 160);
+    bitbuffer_view_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 160);
     // require 72 data bits
     if (packet_bits.bits_per_row[0] < 72) {
         return 0;
@@ -88,7 +88,7 @@ static int tpms_renault_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     int ret    = 0;
     int events = 0;
 
-    bitbuffer_invert(bitbuffer);
+    bitbuffer = bitbuffer_view_invert(bitbuffer);
 
     for (row = 0; row < bitbuffer->num_rows; ++row) {
         bitpos = 0;
@@ -74,7 +74,7 @@ static int tpms_renault_0435r_decode(r_device *decoder, bitbuffer_t *bitbuffer,
 {
     bitbuffer_t packet_bits = {0};
 
-    bitbuffer_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 160);
+    bitbuffer_view_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 160);
     // require 72 data bits
     if (packet_bits.bits_per_row[0] < 72) {
         return DECODE_ABORT_EARLY;
@@ -141,7 +141,7 @@ static int tpms_renault_0435r_callback(r_device *decoder, bitbuffer_t *bitbuffer
     int ret    = 0;
     int events = 0;
 
-    bitbuffer_invert(bitbuffer);
+    bitbuffer = bitbuffer_view_invert(bitbuffer);
 
     for (int row = 0; row < bitbuffer->num_rows; ++row) {
         unsigned bitpos = 0;
@@ -52,7 +52,7 @@ Example data:
 static int tpms_truck_decode(r_device *decoder, bitbuffer_t *bitbuffer, unsigned row, unsigned bitpos)
 {
     bitbuffer_t packet_bits = {0};
-    bitbuffer_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 76);
+    bitbuffer_view_manchester_decode(bitbuffer, row, bitpos, &packet_bits, 76);
 
     if (packet_bits.bits_per_row[row] < 76) {
         return 0; // DECODE_FAIL_SANITY;
@@ -103,7 +103,7 @@ static int tpms_truck_callback(r_device *decoder, bitbuffer_t *bitbuffer)
     unsigned bitpos = 0;
     int events      = 0;
 
-    bitbuffer_invert(bitbuffer);
+    bitbuffer = bitbuffer_view_invert(bitbuffer);
     // Find a preamble with enough bits after it that it could be a complete packet
     while ((bitpos = bitbuffer_search(bitbuffer, 0, bitpos, preamble_pattern, 24)) + 160 <=
             bitbuffer->bits_per_row[0]) {
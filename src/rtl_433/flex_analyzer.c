@@ -0,0 +1,359 @@
+/** @file
+    Compact pulse analyzer that proposes a flex decoder.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "flex_analyzer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitbuffer.h"
+#include "c_util.h"
+#include "data.h"
+#include "pulse_data.h"
+#include "r_api.h"
+#include "r_device.h"
+
+#define TOLERANCE (0.2f) // as pulse_analyzer(), discerns widths of 0.33, 0.66, 1.0
+
+/// Bins with less than 1/GLITCH_SHARE of the widths are ignored by the guess.
+#define GLITCH_SHARE 50
+
+/* histograms, incremental versions of the pulse_analyzer() histograms */
+
+static void hist_add(flex_hist_t* hist, int width) {
+  for (unsigned b = 0; b < hist->bins_count; ++b) {
+    flex_bin_t* bin = &hist->bins[b];
+    if (width == bin->mean || abs(width - bin->mean) < TOLERANCE * MAX(width, bin->mean)) {
+      bin->count++;
+      bin->sum += width;
+      bin->mean = bin->sum / bin->count;
+      bin->min = MIN(width, bin->min);
+      bin->max = MAX(width, bin->max);
+      return;
+    }
+  }
+  if (hist->bins_count < FLEX_ANALYZER_BINS) {
+    hist->bins[hist->bins_count++] = (flex_bin_t){1, width, width, width, width};
+  }
+}
+
+static void hist_delete_bin(flex_hist_t* hist, unsigned index) {
+  for (unsigned n = index; n + 1 < hist->bins_count; ++n)
+    hist->bins[n] = hist->bins[n + 1];
+  hist->bins_count--;
+}
+
+/// Fuse bins whose means moved within tolerance of each other.
+static void hist_fuse_bins(flex_hist_t* hist) {
+  for (unsigned n = 0; n + 1 < hist->bins_count; ++n) {
+    for (unsigned m = n + 1; m < hist->bins_count; ++m) {
+      flex_bin_t* bn = &hist->bins[n];
+      flex_bin_t const* bm = &hist->bins[m];
+      if (abs(bn->mean - bm->mean) < TOLERANCE * MAX(bn->mean, bm->mean)) {
+        bn->count += bm->count;
+        bn->sum += bm->sum;
+        bn->mean = bn->sum / bn->count;
+        bn->min = MIN(bn->min, bm->min);
+        bn->max = MAX(bn->max, bm->max);
+        hist_delete_bin(hist, m);
+        m--; // compare the new bin in the same place
+      }
+    }
+  }
+}
+
+static void hist_prune(flex_hist_t* hist) {
+  unsigned total = 0;
+  for (unsigned n = 0; n < hist->bins_count; ++n)
+    total += hist->bins[n].count;
+  for (unsigned n = 0; n < hist->bins_count; ++n) {
+    if (hist->bins[n].count * GLITCH_SHARE < total)
+      hist_delete_bin(hist, n--);
+  }
+}
+
+static void hist_sort_mean(flex_hist_t* hist) {
+  for (unsigned n = 0; n + 1 < hist->bins_count; ++n) {
+    for (unsigned m = n + 1; m < hist->bins_count; ++m) {
+      if (hist->bins[m].mean < hist->bins[n].mean) {
+        flex_bin_t tmp = hist->bins[n];
+        hist->bins[n] = hist->bins[m];
+        hist->bins[m] = tmp;
+      }
+    }
+  }
+}
+
+/// Index of the bin with the lowest count.
+static unsigned hist_min_count(flex_hist_t const* hist) {
+  unsigned index = 0;
+  for (unsigned n = 1; n < hist->bins_count; ++n) {
+    if (hist->bins[n].count < hist->bins[index].count)
+      index = n;
+  }
+  return index;
+}
+
+/* analyzer */
+
+void flex_analyzer_start(flex_analyzer_t* fa, unsigned trains, unsigned min_pulses, int fsk) {
+  memset(fa, 0, sizeof(*fa));
+  fa->trains_wanted = trains ? trains : 1;
+  fa->min_pulses = min_pulses;
+  fa->fsk = fsk;
+  fa->active = 1;
+}
+
+int flex_analyzer_add(flex_analyzer_t* fa, pulse_data_t const* pulses) {
+  unsigned num_pulses = pulses->num_pulses;
+  if (!fa->active || num_pulses < 2 || num_pulses < fa->min_pulses)
+    return 0;
+
+  for (unsigned n = 0; n < num_pulses; ++n) {
+    hist_add(&fa->hist_pulses, pulses->pulse[n]);
+    // leave out the last gap, it is the end of the train
+    if (n + 1 < num_pulses) {
+      hist_add(&fa->hist_gaps, pulses->gap[n]);
+      hist_add(&fa->hist_periods, pulses->pulse[n] + pulses->gap[n]);
+    }
+  }
+  hist_fuse_bins(&fa->hist_pulses);
+  hist_fuse_bins(&fa->hist_gaps);
+  hist_fuse_bins(&fa->hist_periods);
+
+  if (!fa->trains || num_pulses < fa->min_train_pulses)
+    fa->min_train_pulses = num_pulses;
+  if (num_pulses > fa->max_train_pulses)
+    fa->max_train_pulses = num_pulses;
+  fa->trains++;
+  fa->pulses += num_pulses;
+  fa->rssi_sum += pulses->signalRssi;
+  fa->sample_rate = pulses->sample_rate;
+  return fa->trains >= fa->trains_wanted;
+}
+
+static double to_us(flex_analyzer_t const* fa) {
+  return fa->sample_rate ? 1e6 / fa->sample_rate : 1.0;
+}
+
+void flex_analyzer_guess(flex_analyzer_t const* fa, flex_guess_t* guess) {
+  memset(guess, 0, sizeof(*guess));
+  guess->coding = "No clue";
+  if (!fa->trains) {
+    guess->coding = "No pulses";
+    return;
+  }
+
+  double us = to_us(fa);
+  int fsk = fa->fsk;
+  flex_hist_t pulses = fa->hist_pulses;
+  flex_hist_t gaps = fa->hist_gaps;
+  flex_hist_t periods = fa->hist_periods;
+  hist_prune(&pulses);
+  hist_prune(&gaps);
+  hist_prune(&periods);
+  hist_sort_mean(&pulses);
+  hist_sort_mean(&gaps);
+  if (pulses.bins_count && pulses.bins[0].mean == 0)
+    hist_delete_bin(&pulses, 0); // FSK initial zero-bin
+
+  // the decision rules of pulse_analyzer()
+  if (!pulses.bins_count || !gaps.bins_count) {
+    guess->coding = "Single pulse, probably FSK or just noise";
+  } else if (pulses.bins_count == 1 && gaps.bins_count == 1) {
+    guess->coding = "Un-modulated signal, maybe a preamble";
+  } else if (pulses.bins_count == 1 && gaps.bins_count > 1) {
+    guess->coding = "Pulse Position Modulation with fixed pulse width";
+    guess->modulation = OOK_PULSE_PPM; // there is no FSK_PULSE_PPM
+    guess->short_width = us * gaps.bins[0].mean;
+    guess->long_width = us * gaps.bins[1].mean;
+    guess->gap_limit = us * (gaps.bins[1].max + 1);
+    guess->reset_limit = us * (gaps.bins[gaps.bins_count - 1].max + 1);
+  } else if (pulses.bins_count == 2 && gaps.bins_count == 1) {
+    guess->coding = "Pulse Width Modulation with fixed gap";
+    guess->modulation = fsk ? FSK_PULSE_PWM : OOK_PULSE_PWM;
+    guess->short_width = us * pulses.bins[0].mean;
+    guess->long_width = us * pulses.bins[1].mean;
+    guess->tolerance = (guess->long_width - guess->short_width) * 0.4;
+    guess->reset_limit = us * (gaps.bins[gaps.bins_count - 1].max + 1);
+  } else if (pulses.bins_count == 2 && gaps.bins_count == 2 && periods.bins_count == 1) {
+    guess->coding = "Pulse Width Modulation with fixed period";
+    guess->modulation = fsk ? FSK_PULSE_PWM : OOK_PULSE_PWM;
+    guess->short_width = us * pulses.bins[0].mean;
+    guess->long_width = us * pulses.bins[1].mean;
+    guess->tolerance = (guess->long_width - guess->short_width) * 0.4;
+    guess->reset_limit = us * (gaps.bins[gaps.bins_count - 1].max + 1);
+  } else if (pulses.bins_count == 2 && gaps.bins_count == 2 && periods.bins_count == 3) {
+    guess->coding = "Manchester coding";
+    guess->modulation = fsk ? FSK_PULSE_MANCHESTER_ZEROBIT : OOK_PULSE_MANCHESTER_ZEROBIT;
+    guess->short_width = us * pulses.bins[0].mean; // shortest pulse is half period
+    guess->reset_limit = us * (gaps.bins[gaps.bins_count - 1].max + 1);
+  } else if (pulses.bins_count == 2 && gaps.bins_count >= 3) {
+    guess->coding = "Pulse Width Modulation with multiple packets";
+    guess->modulation = fsk ? FSK_PULSE_PWM : OOK_PULSE_PWM;
+    guess->short_width = us * pulses.bins[0].mean;
+    guess->long_width = us * pulses.bins[1].mean;
+    guess->gap_limit = us * (gaps.bins[1].max + 1);
+    guess->tolerance = (guess->long_width - guess->short_width) * 0.4;
+    guess->reset_limit = us * (gaps.bins[gaps.bins_count - 1].max + 1);
+  } else if (pulses.bins_count >= 3 && gaps.bins_count >= 3 &&
+             abs(pulses.bins[1].mean - 2 * pulses.bins[0].mean) <= pulses.bins[0].mean / 8 &&
+             abs(pulses.bins[2].mean - 3 * pulses.bins[0].mean) <= pulses.bins[0].mean / 8 &&
+             abs(gaps.bins[0].mean - pulses.bins[0].mean) <= pulses.bins[0].mean / 8 &&
+             abs(gaps.bins[1].mean - 2 * pulses.bins[0].mean) <= pulses.bins[0].mean / 8 &&
+             abs(gaps.bins[2].mean - 3 * pulses.bins[0].mean) <= pulses.bins[0].mean / 8) {
+    guess->coding = "Non Return to Zero coding (Pulse Code)";
+    guess->modulation = fsk ? FSK_PULSE_PCM : OOK_PULSE_PCM;
+    guess->short_width = us * pulses.bins[0].mean; // shortest pulse is bit width
+    guess->long_width = us * pulses.bins[0].mean;  // bit period equal to pulse length (NRZ)
+    guess->reset_limit = us * pulses.bins[0].mean * 1024;
+  } else if (pulses.bins_count == 3) {
+    guess->coding = "Pulse Width Modulation with sync/delimiter";
+    // the pulse width with the lowest count is probably the delimiter
+    unsigned sync = hist_min_count(&pulses);
+    int p1 = pulses.bins[sync == 0 ? 1 : 0].mean;
+    int p2 = pulses.bins[sync == 2 ? 1 : 2].mean;
+    guess->modulation = fsk ? FSK_PULSE_PWM : OOK_PULSE_PWM;
+    guess->short_width = us * MIN(p1, p2);
+    guess->long_width = us * MAX(p1, p2);
+    guess->sync_width = us * pulses.bins[sync].mean;
+    guess->reset_limit = us * (gaps.bins[gaps.bins_count - 1].max + 1);
+  }
+}
+
+static char const* modulation_name(unsigned modulation) {
+  switch (modulation) {
+    case OOK_PULSE_PCM: return "OOK_PCM";
+    case OOK_PULSE_PPM: return "OOK_PPM";
+    case OOK_PULSE_PWM: return "OOK_PWM";
+    case OOK_PULSE_MANCHESTER_ZEROBIT: return "OOK_MC_ZEROBIT";
+    case FSK_PULSE_PCM: return "FSK_PCM";
+    case FSK_PULSE_PWM: return "FSK_PWM";
+    case FSK_PULSE_MANCHESTER_ZEROBIT: return "FSK_MC_ZEROBIT";
+    default: return ""; // data_make() copies strings of skipped fields too
+  }
+}
+
+int flex_analyzer_spec(flex_guess_t const* guess, char const* name, char* buf, size_t size) {
+  char const* m = modulation_name(guess->modulation);
+  if (!*m) {
+    if (size)
+      *buf = '\0';
+    return 0;
+  }
+  // the keys pulse_analyzer() suggests for each modulation
+  switch (guess->modulation) {
+    case OOK_PULSE_PPM:
+      return snprintf(buf, size, "n=%s,m=%s,s=%.0f,l=%.0f,g=%.0f,r=%.0f", name, m, guess->short_width,
+                      guess->long_width, guess->gap_limit, guess->reset_limit);
+    case OOK_PULSE_PWM:
+    case FSK_PULSE_PWM:
+      return snprintf(buf, size, "n=%s,m=%s,s=%.0f,l=%.0f,r=%.0f,g=%.0f,t=%.0f,y=%.0f", name, m, guess->short_width,
+                      guess->long_width, guess->reset_limit, guess->gap_limit, guess->tolerance, guess->sync_width);
+    default:
+      return snprintf(buf, size, "n=%s,m=%s,s=%.0f,l=%.0f,r=%.0f", name, m, guess->short_width, guess->long_width,
+                      guess->reset_limit);
+  }
+}
+
+/// Rows sliced with the guess, kept by the decode callback.
+typedef struct slice_result {
+  unsigned rows;
+  unsigned bits; ///< bits of the longest row
+  char hex[2 * 32 + 1];
+} slice_result_t;
+
+static int slice_callback(r_device* decoder, bitbuffer_t* bitbuffer) {
+  slice_result_t* result = decoder->decode_ctx;
+  result->rows = bitbuffer->num_rows;
+  for (unsigned row = 0; row < bitbuffer->num_rows; ++row) {
+    if (bitbuffer->bits_per_row[row] > result->bits) {
+      result->bits = bitbuffer->bits_per_row[row];
+      unsigned bits = MIN(result->bits, (sizeof(result->hex) - 1) * 4);
+      bitrow_snprint(bitbuffer->bb[row], bits, result->hex, sizeof(result->hex));
+    }
+  }
+  return 0;
+}
+
+static data_t* append_hist(data_t* data, char const* widths_key, char const* counts_key, flex_hist_t const* hist,
+                           double us) {
+  flex_hist_t sorted = *hist;
+  hist_sort_mean(&sorted);
+  int widths[FLEX_ANALYZER_BINS];
+  int counts[FLEX_ANALYZER_BINS];
+  for (unsigned n = 0; n < sorted.bins_count; ++n) {
+    widths[n] = sorted.bins[n].mean * us;
+    counts[n] = sorted.bins[n].count;
+  }
+  /* clang-format off */
+  return data_append(data,
+          widths_key, "", DATA_ARRAY, data_array(sorted.bins_count, DATA_INT, widths),
+          counts_key, "", DATA_ARRAY, data_array(sorted.bins_count, DATA_INT, counts),
+          NULL);
+  /* clang-format on */
+}
+
+data_t* flex_analyzer_report(flex_analyzer_t* fa, pulse_data_t* pulses) {
+  fa->active = 0;
+  flex_guess_t guess;
+  flex_analyzer_guess(fa, &guess);
+  char spec[160];
+  flex_analyzer_spec(&guess, "name", spec, sizeof(spec));
+
+  slice_result_t result = {0};
+  if (guess.modulation && pulses && pulses->num_pulses) {
+    r_device device = {.name = "Flex Analyzer", .modulation = guess.modulation};
+    device.short_width = guess.short_width;
+    device.long_width = guess.long_width;
+    device.gap_limit = guess.gap_limit;
+    device.reset_limit = guess.reset_limit;
+    device.sync_width = guess.sync_width;
+    device.tolerance = guess.tolerance;
+    device.decode_fn = slice_callback;
+    device.decode_ctx = &result;
+    // be sure to terminate the package, the classes no longer match the train
+    pulses->gap[pulses->num_pulses - 1] = guess.reset_limit / to_us(fa) + 1;
+    pulses->classes = NULL;
+    if (fa->fsk)
+      run_fsk_demod(&device, pulses);
+    else
+      run_ook_demod(&device, pulses);
+  }
+
+  /* clang-format off */
+  data_t* data = data_make(
+          "model",        "", DATA_STRING, "analyzer",
+          "protocol",     "", DATA_STRING, "rtl_433_ESP flex analyzer",
+          "trains",       "", DATA_INT,    fa->trains,
+          "pulses",       "", DATA_INT,    fa->pulses,
+          "minPulses",    "", DATA_INT,    fa->min_train_pulses,
+          "maxPulses",    "", DATA_INT,    fa->max_train_pulses,
+          "rssi",         "", DATA_INT,    fa->trains ? (int)(fa->rssi_sum / (long)fa->trains) : 0,
+          "coding",       "", DATA_STRING, guess.coding,
+          "modulation",   "", DATA_COND, guess.modulation, DATA_STRING, modulation_name(guess.modulation),
+          "short",        "", DATA_COND, guess.short_width > 0, DATA_INT, (int)guess.short_width,
+          "long",         "", DATA_COND, guess.long_width > 0, DATA_INT, (int)guess.long_width,
+          "gap",          "", DATA_COND, guess.gap_limit > 0, DATA_INT, (int)guess.gap_limit,
+          "reset",        "", DATA_COND, guess.reset_limit > 0, DATA_INT, (int)guess.reset_limit,
+          "sync",         "", DATA_COND, guess.sync_width > 0, DATA_INT, (int)guess.sync_width,
+          "tolerance",    "", DATA_COND, guess.tolerance > 0, DATA_INT, (int)guess.tolerance,
+          "flex",         "", DATA_COND, guess.modulation, DATA_STRING, spec,
+          "rows",         "", DATA_COND, result.rows, DATA_INT, result.rows,
+          "bits",         "", DATA_COND, result.rows, DATA_INT, result.bits,
+          "data",         "", DATA_COND, result.bits, DATA_STRING, result.hex,
+          NULL);
+  /* clang-format on */
+  double us = to_us(fa);
+  data = append_hist(data, "pulseWidths", "pulseCounts", &fa->hist_pulses, us);
+  data = append_hist(data, "gapWidths", "gapCounts", &fa->hist_gaps, us);
+  data = append_hist(data, "periodWidths", "periodCounts", &fa->hist_periods, us);
+  return data;
+}
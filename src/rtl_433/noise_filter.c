@@ -0,0 +1,97 @@
+/** @file
+    Noise train rejection before a train is queued for decoding.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "noise_filter.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "pulse_data.h"
+
+/// Log2 width bins with 3 fraction bits, about 9% per bin.
+#define NOISE_BINS 256
+
+/// Duty cycle in percent outside of which a train is noise.
+#define NOISE_MIN_DUTY 1
+#define NOISE_MAX_DUTY 99
+
+/// Minimum score per level.
+static int const noise_thresholds[NOISE_LEVELS] = {0, 50, 65, 80};
+
+static unsigned noise_bin(int width) {
+  if (width <= 1)
+    return 0;
+  uint32_t w = width;
+  int msb = 31 - __builtin_clz(w);
+  uint32_t frac = msb >= 3 ? (w >> (msb - 3)) & 0x7 : (w << (3 - msb)) & 0x7;
+  return (msb << 3) | frac;
+}
+
+/// Share of widths in percent in the NOISE_CLUSTERS fullest clusters of three adjacent bins.
+static int noise_coverage(int const* widths, unsigned len) {
+  uint16_t hist[NOISE_BINS + 2] = {0}; // a zero bin on either side
+  for (unsigned n = 0; n < len; ++n)
+    hist[1 + noise_bin(widths[n])]++;
+
+  unsigned covered = 0;
+  for (int c = 0; c < NOISE_CLUSTERS; ++c) {
+    unsigned best = 0;
+    unsigned best_sum = 0;
+    for (unsigned b = 1; b <= NOISE_BINS; ++b) {
+      unsigned sum = hist[b - 1] + hist[b] + hist[b + 1];
+      if (sum > best_sum) {
+        best = b;
+        best_sum = sum;
+      }
+    }
+    if (!best_sum)
+      break;
+    covered += best_sum;
+    hist[best - 1] = hist[best] = hist[best + 1] = 0;
+  }
+  return covered * 100 / len;
+}
+
+int noise_score(pulse_data_t const* pulses) {
+  unsigned num_pulses = pulses->num_pulses;
+  if (num_pulses < 2)
+    return 100;
+
+  // the trailing gap is the end of the signal, not a symbol
+  uint64_t high = 0;
+  uint64_t low = 0;
+  for (unsigned n = 0; n < num_pulses; ++n) {
+    high += pulses->pulse[n] > 0 ? pulses->pulse[n] : 0;
+    if (n + 1 < num_pulses)
+      low += pulses->gap[n] > 0 ? pulses->gap[n] : 0;
+  }
+  if (!high || !low)
+    return 0;
+  uint64_t duty = high * 100 / (high + low);
+  if (duty < NOISE_MIN_DUTY || duty > NOISE_MAX_DUTY)
+    return 0;
+
+  int pulse_score = noise_coverage(pulses->pulse, num_pulses);
+  int gap_score = noise_coverage(pulses->gap, num_pulses - 1);
+  return pulse_score < gap_score ? pulse_score : gap_score;
+}
+
+int noise_filter_train(noise_filter_t* filter, pulse_data_t const* pulses) {
+  if (filter->level <= NOISE_LEVEL_OFF || filter->level >= NOISE_LEVELS)
+    return 1;
+  if (noise_score(pulses) >= noise_thresholds[filter->level])
+    return 1;
+
+  filter->rejected++;
+  if (filter->sample_every && filter->rejected % filter->sample_every == 0) {
+    filter->sampled++;
+    return 2;
+  }
+  return 0;
+}
@@ -12,6 +12,7 @@
 #include "pulse_analyzer.h"
 #include "pulse_slicer.h"
 #include "bit_util.h"
+#include "c_util.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -0,0 +1,271 @@
+/** @file
+    Binary capture container for pulse trains.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "pulse_capture.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pulse_data.h"
+
+#define CAPTURE_HEADER_LEN 8
+#define CAPTURE_FOOTER_LEN 8
+#define CAPTURE_TRAIN      'T'
+#define CAPTURE_INDEX      'I'
+#define CAPTURE_FLAG_FSK   0x01
+
+/* writer */
+
+/// Record encoder, counts the record length when writer is NULL.
+typedef struct emit {
+  pulse_capture_writer_t* writer;
+  uint32_t count;
+  unsigned fill;
+  uint8_t buf[64];
+} emit_t;
+
+static void capture_put(pulse_capture_writer_t* writer, void const* buf, size_t len) {
+  if (writer->write(buf, len, writer->ctx) != len)
+    writer->error = 1;
+  writer->pos += len;
+}
+
+static void emit_flush(emit_t* e) {
+  if (e->writer && e->fill)
+    capture_put(e->writer, e->buf, e->fill);
+  e->fill = 0;
+}
+
+static void emit_byte(emit_t* e, uint8_t b) {
+  e->count++;
+  if (!e->writer)
+    return;
+  e->buf[e->fill++] = b;
+  if (e->fill == sizeof(e->buf))
+    emit_flush(e);
+}
+
+static void emit_varint(emit_t* e, uint64_t v) {
+  while (v >= 0x80) {
+    emit_byte(e, (v & 0x7f) | 0x80);
+    v >>= 7;
+  }
+  emit_byte(e, v);
+}
+
+static void emit_zigzag(emit_t* e, int64_t v) {
+  emit_varint(e, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static void emit_train(emit_t* e, pulse_data_t const* data) {
+  int fsk = data->fsk_f2_est != 0;
+  emit_varint(e, fsk ? CAPTURE_FLAG_FSK : 0);
+  emit_varint(e, data->offset);
+  emit_varint(e, data->sample_rate);
+  emit_zigzag(e, data->signalRssi);
+  emit_varint(e, data->signalDuration);
+  emit_varint(e, (uint32_t)data->freq1_hz);
+  if (fsk)
+    emit_varint(e, (uint32_t)data->freq2_hz);
+  emit_varint(e, data->num_pulses);
+  int pulse = 0;
+  int gap = 0;
+  for (unsigned n = 0; n < data->num_pulses; ++n) {
+    emit_zigzag(e, (int64_t)data->pulse[n] - pulse);
+    emit_zigzag(e, (int64_t)data->gap[n] - gap);
+    pulse = data->pulse[n];
+    gap = data->gap[n];
+  }
+}
+
+static void put_le32(uint8_t* buf, uint32_t v) {
+  buf[0] = v;
+  buf[1] = v >> 8;
+  buf[2] = v >> 16;
+  buf[3] = v >> 24;
+}
+
+int pulse_capture_writer_init(pulse_capture_writer_t* writer, pulse_capture_write_fn write, void* ctx) {
+  *writer = (pulse_capture_writer_t){.write = write, .ctx = ctx};
+  uint8_t header[CAPTURE_HEADER_LEN] = {'R', 'C', 'A', 'P', PULSE_CAPTURE_VERSION, 0, 0, 0};
+  capture_put(writer, header, sizeof(header));
+  return writer->error ? -1 : 0;
+}
+
+int pulse_capture_write(pulse_capture_writer_t* writer, pulse_data_t const* data) {
+  if (writer->num_trains >= writer->index_size) {
+    unsigned size = writer->index_size ? writer->index_size * 2 : 64;
+    uint32_t* index = realloc(writer->index, size * sizeof(*index));
+    if (!index) {
+      writer->error = 1;
+      return -1;
+    }
+    writer->index = index;
+    writer->index_size = size;
+  }
+  writer->index[writer->num_trains++] = writer->pos;
+
+  emit_t e = {0};
+  emit_train(&e, data);
+  uint32_t len = e.count;
+
+  e = (emit_t){.writer = writer};
+  emit_byte(&e, CAPTURE_TRAIN);
+  emit_varint(&e, len);
+  emit_train(&e, data);
+  emit_flush(&e);
+  return writer->error ? -1 : 0;
+}
+
+int pulse_capture_writer_close(pulse_capture_writer_t* writer) {
+  uint32_t index_pos = writer->pos;
+  emit_t e = {.writer = writer};
+  emit_byte(&e, CAPTURE_INDEX);
+  emit_varint(&e, writer->num_trains);
+  for (unsigned n = 0; n < writer->num_trains; ++n) {
+    uint8_t le[4];
+    put_le32(le, writer->index[n]);
+    for (unsigned i = 0; i < sizeof(le); ++i)
+      emit_byte(&e, le[i]);
+  }
+  emit_flush(&e);
+
+  uint8_t footer[CAPTURE_FOOTER_LEN] = {0, 0, 0, 0, 'R', 'I', 'D', 'X'};
+  put_le32(footer, index_pos);
+  capture_put(writer, footer, sizeof(footer));
+
+  free(writer->index);
+  writer->index = NULL;
+  writer->index_size = 0;
+  return writer->error ? -1 : 0;
+}
+
+/* reader */
+
+static uint32_t get_le32(uint8_t const* buf) {
+  return buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t)buf[3] << 24;
+}
+
+static int read_varint(uint8_t const** p, uint8_t const* end, uint64_t* v) {
+  uint64_t value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (*p >= end)
+      return -1;
+    uint8_t b = *(*p)++;
+    value |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) {
+      *v = value;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+static int read_zigzag(uint8_t const** p, uint8_t const* end, int64_t* v) {
+  uint64_t u;
+  if (read_varint(p, end, &u))
+    return -1;
+  *v = (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+  return 0;
+}
+
+/// Find the record offsets of a capture without index.
+static int capture_scan(pulse_capture_reader_t* reader) {
+  unsigned size = 0;
+  uint8_t const* end = reader->data + reader->len;
+  uint8_t const* p = reader->data + CAPTURE_HEADER_LEN;
+  while (p < end && *p == CAPTURE_TRAIN) {
+    uint8_t const* record = p++;
+    uint64_t len;
+    if (read_varint(&p, end, &len) || len > (uint64_t)(end - p))
+      break; // truncated record
+    p += len;
+    if (reader->num_trains >= size) {
+      size = size ? size * 2 : 64;
+      uint32_t* offsets = realloc(reader->offsets, size * sizeof(*offsets));
+      if (!offsets)
+        return -1;
+      reader->offsets = offsets;
+    }
+    reader->offsets[reader->num_trains++] = record - reader->data;
+  }
+  return 0;
+}
+
+int pulse_capture_reader_init(pulse_capture_reader_t* reader, void const* data, size_t len) {
+  *reader = (pulse_capture_reader_t){.data = data, .len = len};
+  uint8_t const* buf = data;
+  if (len < CAPTURE_HEADER_LEN || memcmp(buf, "RCAP", 4) || buf[4] != PULSE_CAPTURE_VERSION)
+    return -1;
+
+  if (len >= CAPTURE_HEADER_LEN + CAPTURE_FOOTER_LEN && !memcmp(buf + len - 4, "RIDX", 4)) {
+    uint32_t index_pos = get_le32(buf + len - CAPTURE_FOOTER_LEN);
+    uint8_t const* end = buf + len - CAPTURE_FOOTER_LEN;
+    uint8_t const* p = buf + index_pos;
+    uint64_t count;
+    if (index_pos >= CAPTURE_HEADER_LEN && index_pos < len - CAPTURE_FOOTER_LEN && *p++ == CAPTURE_INDEX &&
+        !read_varint(&p, end, &count) && count <= (uint64_t)(end - p) / 4) {
+      reader->index = p;
+      reader->num_trains = count;
+      return 0;
+    }
+  }
+  return capture_scan(reader);
+}
+
+void pulse_capture_reader_free(pulse_capture_reader_t* reader) {
+  free(reader->offsets);
+  reader->offsets = NULL;
+  reader->num_trains = 0;
+}
+
+int pulse_capture_read(pulse_capture_reader_t const* reader, unsigned n, pulse_data_t* data) {
+  if (n >= reader->num_trains)
+    return -1;
+  uint32_t pos = reader->index ? get_le32(reader->index + 4 * n) : reader->offsets[n];
+  if (pos >= reader->len || reader->data[pos] != CAPTURE_TRAIN)
+    return -1;
+
+  uint8_t const* p = reader->data + pos + 1;
+  uint8_t const* end = reader->data + reader->len;
+  uint64_t len;
+  if (read_varint(&p, end, &len) || len > (uint64_t)(end - p))
+    return -1;
+  end = p + len;
+
+  uint64_t flags, offset, sample_rate, duration, freq1, freq2 = 0, num_pulses;
+  int64_t rssi;
+  if (read_varint(&p, end, &flags) || read_varint(&p, end, &offset) || read_varint(&p, end, &sample_rate) ||
+      read_zigzag(&p, end, &rssi) || read_varint(&p, end, &duration) || read_varint(&p, end, &freq1) ||
+      ((flags & CAPTURE_FLAG_FSK) && read_varint(&p, end, &freq2)) || read_varint(&p, end, &num_pulses) ||
+      num_pulses > PD_MAX_PULSES)
+    return -1;
+
+  memset(data, 0, sizeof(*data));
+  data->offset = offset;
+  data->sample_rate = sample_rate;
+  data->signalRssi = rssi;
+  data->signalDuration = duration;
+  data->freq1_hz = freq1;
+  data->freq2_hz = freq2;
+  data->fsk_f2_est = (flags & CAPTURE_FLAG_FSK) ? 1 : 0;
+  int64_t pulse = 0;
+  int64_t gap = 0;
+  for (unsigned i = 0; i < num_pulses; ++i) {
+    int64_t dp, dg;
+    if (read_zigzag(&p, end, &dp) || read_zigzag(&p, end, &dg))
+      return -1;
+    pulse += dp;
+    gap += dg;
+    data->pulse[i] = pulse;
+    data->gap[i] = gap;
+  }
+  data->num_pulses = num_pulses;
+  return 0;
+}
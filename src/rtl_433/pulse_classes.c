@@ -0,0 +1,122 @@
+/** @file
+    Pulse and gap width classes shared by all slicers.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "pulse_classes.h"
+
+#include <stdlib.h>
+
+#include "c_util.h"
+
+static int classes_close(int a, int b) {
+  return abs(a - b) < PULSE_CLASSES_TOLERANCE * MAX(a, b);
+}
+
+static void class_add(pulse_class_t* bin, int width) {
+  bin->count++;
+  bin->sum += width;
+  bin->mean = bin->sum / (int)bin->count;
+  bin->min = MIN(width, bin->min);
+  bin->max = MAX(width, bin->max);
+}
+
+/// Sort widths into classes (unsorted), a full table adds to the nearest class.
+static unsigned classes_sum(pulse_class_t* bins, int const* data, unsigned len, uint8_t* index) {
+  unsigned count = 0;
+  for (unsigned n = 0; n < len; ++n) {
+    int width = data[n];
+    unsigned bin;
+    for (bin = 0; bin < count; ++bin) {
+      if (classes_close(width, bins[bin].mean))
+        break;
+    }
+    if (bin == count && count < PULSE_CLASSES_MAX) {
+      bins[bin].count = 1;
+      bins[bin].sum = width;
+      bins[bin].mean = width;
+      bins[bin].min = width;
+      bins[bin].max = width;
+      count++;
+    } else {
+      if (bin == count) {
+        // no room, min and max stay exact so slicers will check members
+        bin = 0;
+        for (unsigned b = 1; b < count; ++b) {
+          if (abs(width - bins[b].mean) < abs(width - bins[bin].mean))
+            bin = b;
+        }
+      }
+      class_add(&bins[bin], width);
+    }
+    index[n] = bin;
+  }
+  return count;
+}
+
+/// Fuse classes with means within tolerance, sort by mean and renumber members.
+static unsigned classes_finish(pulse_class_t* bins, unsigned count, uint8_t* index, unsigned len) {
+  uint8_t map[PULSE_CLASSES_MAX];
+  unsigned const num_bins = count;
+  for (unsigned i = 0; i < num_bins; ++i)
+    map[i] = i;
+
+  for (unsigned n = 0; count > 1 && n < count - 1; ++n) {
+    for (unsigned m = n + 1; m < count; ++m) {
+      if (!classes_close(bins[n].mean, bins[m].mean))
+        continue;
+      bins[n].count += bins[m].count;
+      bins[n].sum += bins[m].sum;
+      bins[n].mean = bins[n].sum / (int)bins[n].count;
+      bins[n].min = MIN(bins[n].min, bins[m].min);
+      bins[n].max = MAX(bins[n].max, bins[m].max);
+      for (unsigned k = m; k < count - 1; ++k)
+        bins[k] = bins[k + 1];
+      for (unsigned i = 0; i < num_bins; ++i) {
+        if (map[i] == m)
+          map[i] = n;
+        else if (map[i] > m)
+          map[i]--;
+      }
+      count--;
+      m--;
+    }
+  }
+
+  for (unsigned n = 0; count > 1 && n < count - 1; ++n) {
+    for (unsigned m = n + 1; m < count; ++m) {
+      if (bins[m].mean >= bins[n].mean)
+        continue;
+      pulse_class_t tmp = bins[n];
+      bins[n] = bins[m];
+      bins[m] = tmp;
+      for (unsigned i = 0; i < num_bins; ++i) {
+        if (map[i] == n)
+          map[i] = m;
+        else if (map[i] == m)
+          map[i] = n;
+      }
+    }
+  }
+
+  for (unsigned n = 0; n < len; ++n)
+    index[n] = map[index[n]];
+  return count;
+}
+
+void pulse_classes_build(pulse_classes_t* classes, pulse_data_t* pulses) {
+  unsigned len = MIN(pulses->num_pulses, PD_MAX_PULSES);
+
+  unsigned count = classes_sum(classes->pulse, pulses->pulse, len, classes->pulse_class);
+  classes->pulse_count = classes_finish(classes->pulse, count, classes->pulse_class, len);
+  count = classes_sum(classes->gap, pulses->gap, len, classes->gap_class);
+  classes->gap_count = classes_finish(classes->gap, count, classes->gap_class, len);
+
+  classes->num_pulses = len;
+  classes->pulses = pulses;
+  pulses->classes = classes;
+}
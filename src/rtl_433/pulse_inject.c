@@ -0,0 +1,86 @@
+/** @file
+    Pulse trains from text, for injection into the decoder.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "pulse_inject.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pulse_data.h"
+#include "rfraw.h"
+
+static char const* next_line(char const* p) {
+  p = strchr(p, '\n');
+  return p ? p + 1 : NULL;
+}
+
+static char const* skip_blanks(char const* p) {
+  while (*p == ' ' || *p == '\t' || *p == '\r')
+    ++p;
+  return p;
+}
+
+char const* pulse_inject_parse(pulse_data_t* data, char const* text) {
+  pulse_data_clear(data);
+  data->sample_rate = 1000000;
+  for (char const* line = text; line && *line; line = next_line(line)) {
+    char const* p = skip_blanks(line);
+    if (*p == '\n' || !*p)
+      continue;
+
+    if (*p == ';') {
+      if (data->num_pulses)
+        return !strncmp(p, ";end", 4) ? next_line(line) : line; // end or next header found
+      if (!strncmp(p, ";fsk", 4))
+        data->fsk_f2_est = 1;
+      else if (!strncmp(p, ";freq1", 6))
+        data->freq1_hz = strtol(p + 6, NULL, 10);
+      else if (!strncmp(p, ";freq2", 6))
+        data->freq2_hz = strtol(p + 6, NULL, 10);
+      else if (!strncmp(p, ";rssi", 5))
+        data->signalRssi = strtol(p + 5, NULL, 10);
+      continue;
+    }
+
+    // RfRaw and pulse strings are a train each
+    if (rfraw_check(p) || *p == '+') {
+      if (data->num_pulses)
+        return line;
+      if (*p == '+' ? pulse_str_parse(data, p) : rfraw_parse(data, p))
+        return next_line(line) ? next_line(line) : line + strlen(line);
+      continue;
+    }
+
+    char* end;
+    long pulse = strtol(p, &end, 10);
+    if (end == p)
+      continue; // not a pulse line, e.g. a comment
+    long gap = strtol(end, NULL, 10);
+    if (data->num_pulses < PD_MAX_PULSES) {
+      data->pulse[data->num_pulses] = pulse;
+      data->gap[data->num_pulses] = gap;
+      data->num_pulses++;
+    }
+  }
+  if (!data->num_pulses)
+    return NULL;
+  return text + strlen(text);
+}
+
+void pulse_inject_prepare(pulse_data_t* data) {
+  if (!data->sample_rate)
+    data->sample_rate = 1000000;
+  if (data->signalDuration || !data->num_pulses)
+    return;
+  // from the first pulse to the end of the last, in us
+  double duration = 0;
+  for (unsigned i = 0; i < data->num_pulses; ++i)
+    duration += data->pulse[i] + (i + 1 < data->num_pulses ? data->gap[i] : 0);
+  data->signalDuration = duration * 1e6 / data->sample_rate;
+}
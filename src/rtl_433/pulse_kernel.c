@@ -0,0 +1,129 @@
+/** @file
+    Block classification kernels for the pulse slicers.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "pulse_kernel.h"
+
+#if !defined(PULSE_KERNEL_SCALAR) && defined(__AVX2__)
+#  include <immintrin.h>
+#  define PULSE_KERNEL_AVX2
+#elif !defined(PULSE_KERNEL_SCALAR) && defined(__SSE2__)
+#  include <emmintrin.h>
+#  define PULSE_KERNEL_SSE2
+#elif !defined(PULSE_KERNEL_SCALAR)
+#  define PULSE_KERNEL_SWAR
+#endif
+
+#if defined(PULSE_KERNEL_AVX2) || defined(PULSE_KERNEL_SSE2)
+/// Pack 16 masks held in 4x4 32-bit lanes into bytes.
+static inline void kernel_store16(uint8_t* masks, __m128i m0, __m128i m1, __m128i m2, __m128i m3) {
+  // masks are at most 0xff, no saturation happens
+  __m128i lo = _mm_packs_epi32(m0, m1);
+  __m128i hi = _mm_packs_epi32(m2, m3);
+  _mm_storeu_si128((__m128i*)masks, _mm_packus_epi16(lo, hi));
+}
+#endif
+
+#ifdef PULSE_KERNEL_AVX2
+static unsigned kernel_gt_simd(int const* widths, unsigned len, int const* thresholds, unsigned num_thresholds, uint8_t* masks) {
+  __m256i t[PULSE_KERNEL_MAX_THRESHOLDS];
+  __m256i bit[PULSE_KERNEL_MAX_THRESHOLDS];
+  for (unsigned k = 0; k < num_thresholds; ++k) {
+    t[k] = _mm256_set1_epi32(thresholds[k]);
+    bit[k] = _mm256_set1_epi32(1 << k);
+  }
+  unsigned n = 0;
+  for (; n + 16 <= len; n += 16) {
+    __m256i w0 = _mm256_loadu_si256((__m256i const*)&widths[n]);
+    __m256i w1 = _mm256_loadu_si256((__m256i const*)&widths[n + 8]);
+    __m256i m0 = _mm256_setzero_si256();
+    __m256i m1 = _mm256_setzero_si256();
+    for (unsigned k = 0; k < num_thresholds; ++k) {
+      m0 = _mm256_or_si256(m0, _mm256_and_si256(_mm256_cmpgt_epi32(w0, t[k]), bit[k]));
+      m1 = _mm256_or_si256(m1, _mm256_and_si256(_mm256_cmpgt_epi32(w1, t[k]), bit[k]));
+    }
+    // 256-bit packs work per 128-bit lane, pack the halves instead
+    kernel_store16(&masks[n], _mm256_castsi256_si128(m0), _mm256_extracti128_si256(m0, 1),
+                   _mm256_castsi256_si128(m1), _mm256_extracti128_si256(m1, 1));
+  }
+  return n;
+}
+#endif
+
+#ifdef PULSE_KERNEL_SSE2
+static unsigned kernel_gt_simd(int const* widths, unsigned len, int const* thresholds, unsigned num_thresholds, uint8_t* masks) {
+  __m128i t[PULSE_KERNEL_MAX_THRESHOLDS];
+  __m128i bit[PULSE_KERNEL_MAX_THRESHOLDS];
+  for (unsigned k = 0; k < num_thresholds; ++k) {
+    t[k] = _mm_set1_epi32(thresholds[k]);
+    bit[k] = _mm_set1_epi32(1 << k);
+  }
+  unsigned n = 0;
+  for (; n + 16 <= len; n += 16) {
+    __m128i m[4];
+    for (unsigned j = 0; j < 4; ++j) {
+      __m128i w = _mm_loadu_si128((__m128i const*)&widths[n + 4 * j]);
+      m[j] = _mm_setzero_si128();
+      for (unsigned k = 0; k < num_thresholds; ++k)
+        m[j] = _mm_or_si128(m[j], _mm_and_si128(_mm_cmpgt_epi32(w, t[k]), bit[k]));
+    }
+    kernel_store16(&masks[n], m[0], m[1], m[2], m[3]);
+  }
+  return n;
+}
+#endif
+
+#ifdef PULSE_KERNEL_SWAR
+/// Two widths below 0x8000 share a 32-bit word, one per 16-bit lane.
+/// Adding 0x7fff - t to a lane sets its bit 15 exactly if the width is
+/// greater than t, and never carries into the next lane.
+static unsigned kernel_gt_simd(int const* widths, unsigned len, int const* thresholds, unsigned num_thresholds, uint8_t* masks) {
+  uint32_t add[PULSE_KERNEL_MAX_THRESHOLDS];
+  unsigned always = 0; // thresholds below any lane width
+  for (unsigned k = 0; k < num_thresholds; ++k) {
+    int t = thresholds[k];
+    if (t < 0) {
+      add[k] = 0;
+      always |= 1 << k;
+    } else if (t >= 0x7fff) {
+      add[k] = 0; // above any lane width
+    } else {
+      add[k] = (uint32_t)(0x7fff - t) * 0x10001u;
+    }
+  }
+  unsigned n = 0;
+  for (; n + 2 <= len; n += 2) {
+    uint32_t a = (uint32_t)widths[n];
+    uint32_t b = (uint32_t)widths[n + 1];
+    if ((a | b) & ~0x7fffu) {
+      // long gaps and negative widths take the scalar path
+      masks[n] = pulse_kernel_mask(widths[n], thresholds, num_thresholds);
+      masks[n + 1] = pulse_kernel_mask(widths[n + 1], thresholds, num_thresholds);
+      continue;
+    }
+    uint32_t x = a | b << 16;
+    uint32_t m = 0;
+    for (unsigned k = 0; k < num_thresholds; ++k) {
+      if (add[k])
+        m |= ((x + add[k]) >> 15 & 0x10001u) << k;
+    }
+    masks[n] = (uint8_t)(m | always);
+    masks[n + 1] = (uint8_t)(m >> 16 | always);
+  }
+  return n;
+}
+#endif
+
+void pulse_kernel_gt(int const* widths, unsigned len, int const* thresholds, unsigned num_thresholds, uint8_t* masks) {
+  unsigned n = 0;
+#ifndef PULSE_KERNEL_SCALAR
+  n = kernel_gt_simd(widths, len, thresholds, num_thresholds, masks);
+#endif
+  for (; n < len; ++n)
+    masks[n] = pulse_kernel_mask(widths[n], thresholds, num_thresholds);
+}
@@ -0,0 +1,164 @@
+/** @file
+    Separation of two overlapping OOK transmitters by pulse level.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "pulse_separate.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "pulse_data.h"
+#include "rssi_ring.h"
+
+#ifdef SIGNAL_RSSI
+#  define WIDTH_BINS 64 ///< quarter octave bins of the pulse widths
+
+static int width_bin(int width) {
+  int bin = width > 1 ? (int)(log2f(width) * 4) : 0;
+  return bin < WIDTH_BINS ? bin : WIDTH_BINS - 1;
+}
+#endif
+
+int pulse_separate(pulse_separator_t* sep, pulse_data_t const* pulses, uint8_t* level) {
+#ifdef SIGNAL_RSSI
+  unsigned n = pulses->num_pulses;
+  if (n < 2 * PD_MIN_PULSES)
+    return 0;
+  // only pulses with a sample are clustered
+  unsigned measured = 0;
+  int lo = 0;
+  int hi = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    int rssi = pulses->rssi[i];
+    if (rssi == RSSI_RING_NONE)
+      continue;
+    lo = !measured || rssi < lo ? rssi : lo;
+    hi = !measured || rssi > hi ? rssi : hi;
+    measured++;
+  }
+  if (measured < PD_MIN_PULSES || hi - lo < sep->min_db)
+    return 0;
+
+  // two-means of the pulse levels, from the extremes
+  float center[2] = {lo, hi};
+  for (int iter = 0; iter < 16; ++iter) {
+    float mid = (center[0] + center[1]) / 2;
+    float sum[2] = {0, 0};
+    unsigned count[2] = {0, 0};
+    for (unsigned i = 0; i < n; ++i) {
+      if (pulses->rssi[i] == RSSI_RING_NONE)
+        continue;
+      int k = pulses->rssi[i] > mid;
+      sum[k] += pulses->rssi[i];
+      count[k]++;
+    }
+    if (!count[0] || !count[1])
+      return 0;
+    float c0 = sum[0] / count[0];
+    float c1 = sum[1] / count[1];
+    if (c0 == center[0] && c1 == center[1])
+      break;
+    center[0] = c0;
+    center[1] = c1;
+  }
+  if (center[1] - center[0] < sep->min_db)
+    return 0;
+
+  // the widths of the pulses clearly of one level
+  float mid = (center[0] + center[1]) / 2;
+  float margin = (center[1] - center[0]) / 4;
+  uint16_t hist[2][WIDTH_BINS] = {{0}};
+  unsigned clear[2] = {0, 0};
+  for (unsigned i = 0; i < n; ++i) {
+    if (pulses->rssi[i] == RSSI_RING_NONE || fabsf(pulses->rssi[i] - mid) < margin)
+      continue;
+    int k = pulses->rssi[i] > mid;
+    hist[k][width_bin(pulses->pulse[i])]++;
+    clear[k]++;
+  }
+
+  // pulses near the middle or without a sample go to the level with the most
+  // similar widths, else by their level or as the pulse before
+  unsigned count[2] = {0, 0};
+  int k = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    int none = pulses->rssi[i] == RSSI_RING_NONE;
+    if (!none)
+      k = pulses->rssi[i] > mid;
+    if ((none || fabsf(pulses->rssi[i] - mid) < margin) && clear[0] && clear[1]) {
+      int bin = width_bin(pulses->pulse[i]);
+      unsigned like[2];
+      for (int j = 0; j < 2; ++j)
+        like[j] = hist[j][bin] + (bin > 0 ? hist[j][bin - 1] : 0) + (bin + 1 < WIDTH_BINS ? hist[j][bin + 1] : 0);
+      // compare the shares of the widths of each level
+      unsigned long share0 = (unsigned long)like[0] * clear[1];
+      unsigned long share1 = (unsigned long)like[1] * clear[0];
+      if (share0 != share1)
+        k = share1 > share0;
+    }
+    level[i] = k;
+    count[k]++;
+  }
+  if (count[0] < PD_MIN_PULSES || count[1] < PD_MIN_PULSES)
+    return 0;
+
+  sep->split++;
+  return 1;
+#else
+  (void)sep;
+  (void)pulses;
+  (void)level;
+  return 0;
+#endif
+}
+
+void pulse_separate_train(pulse_data_t const* pulses, uint8_t const* level, int which, pulse_data_t* out) {
+  // all but the widths
+  memcpy(out, pulses, offsetof(pulse_data_t, pulse));
+  memcpy(&out->ook_low_estimate, &pulses->ook_low_estimate,
+          sizeof(pulse_data_t) - offsetof(pulse_data_t, ook_low_estimate));
+  out->classes = NULL;
+
+  unsigned k = 0;
+  long t = 0;     // start of the pulse
+  long first = 0; // start of the first pulse taken
+  long end = 0;   // end of the last pulse taken
+#ifdef SIGNAL_RSSI
+  long sum = 0;
+  unsigned measured = 0;
+#endif
+  for (unsigned i = 0; i < pulses->num_pulses; ++i) {
+    if (level[i] == which) {
+      if (k)
+        out->gap[k - 1] = t - end;
+      else
+        first = t;
+      out->pulse[k] = pulses->pulse[i];
+#ifdef SIGNAL_RSSI
+      out->rssi[k] = pulses->rssi[i];
+      if (pulses->rssi[i] != RSSI_RING_NONE) {
+        sum += pulses->rssi[i];
+        measured++;
+      }
+#endif
+      end = t + pulses->pulse[i];
+      k++;
+    }
+    t += pulses->pulse[i] + pulses->gap[i];
+  }
+  if (k) {
+    out->gap[k - 1] = t - end;
+    out->signalDuration = end - first;
+#ifdef SIGNAL_RSSI
+    if (measured)
+      out->signalRssi = sum / (long)measured;
+#endif
+  }
+  out->num_pulses = k;
+}
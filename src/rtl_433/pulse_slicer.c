@@ -23,12 +23,25 @@
 #include "decoder_util.h" // TODO: this should be refactored
 #include "logger.h"
 #include "pulse_data.h"
+#include "pulse_classes.h"
+#include "pulse_kernel.h"
 #include "bit_util.h"
+#include "bitbuffer_view.h"
 #include "c_util.h"
 
-bitbuffer_t bits = {0};
+static R_THREAD_LOCAL bitbuffer_t bits = {0};
 
-static int account_event(r_device* device, bitbuffer_t* bits, char const* demod_name) {
+/// Symbols produced by classifying a pulse or gap width.
+enum slicer_symbol {
+  SYMBOL_UNKNOWN = -1, ///< class straddles a bound, classify members individually
+  SYMBOL_ZERO,
+  SYMBOL_ONE,
+  SYMBOL_SYNC,
+  SYMBOL_ROW,
+  SYMBOL_NONE,
+};
+
+static int decode_event(r_device* device, bitbuffer_t* bits, char const* demod_name) {
   // run decoder
   int ret = 0;
   if (device->decode_fn) {
@@ -63,6 +76,65 @@ static int account_event(r_device* device, bitbuffer_t* bits, char const* demod_
   return ret;
 }
 
+#ifdef SHARED_SLICES
+static R_THREAD_LOCAL int share_slices;
+
+void pulse_slicer_share_slices(int share) {
+  share_slices = share;
+}
+#endif
+
+static int account_event(r_device* device, bitbuffer_t* bits, char const* demod_name) {
+#ifdef SHARED_SLICES
+  if (share_slices && device->slice_next) {
+    // the decoders of the same modulation and timing decode this slice in turn
+    bitbuffer_view_begin(bits);
+    int ret = device->slice_skip ? 0 : decode_event(device, bits, demod_name);
+    for (r_device* next = device->slice_next; next; next = next->slice_next) {
+      if (next->slice_skip)
+        continue;
+      bitbuffer_view_restore(bits);
+      ret += decode_event(next, bits, demod_name);
+    }
+    bitbuffer_view_end();
+    return ret;
+  }
+#endif
+  return decode_event(device, bits, demod_name);
+}
+
+static inline int pcm_highs(int pulse, float f_short) {
+  return pulse * f_short + 0.5;
+}
+
+static inline int pcm_lows(int gap, int s_short, int s_long, float f_long) {
+  return (gap + s_short - s_long) * f_long + 0.5;
+}
+
+/// Tally a NRZ width of 1 or 2 bit periods within tolerance,
+/// the mask is against s_bit - s_tolerance - 1, s_bit + s_tolerance and the same for 2 * s_bit.
+static inline void nrz_tally(int width, unsigned mask, int* nrz_width, int* nrz_count) {
+  if ((mask & 0x3) == 0x1) {
+    *nrz_width += width;
+    *nrz_count += 1;
+  }
+  if ((mask & 0xc) == 0x4) {
+    *nrz_width += width;
+    *nrz_count += 2;
+  }
+}
+
+/// Tally all members of a class that does not straddle a NRZ bound.
+static inline void nrz_tally_class(pulse_class_t const* c, int const* thresholds, int* nrz_width, int* nrz_count) {
+  int width = 0;
+  int count = 0;
+  nrz_tally(c->min, pulse_kernel_mask(c->min, thresholds, 4), &width, &count);
+  if (count) {
+    *nrz_width += c->sum * (count == 3 ? 2 : 1);
+    *nrz_count += c->count * count;
+  }
+}
+
 int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
   float samples_per_us = pulses->sample_rate / 1.0e6;
   int s_short = device->short_width * samples_per_us;
@@ -85,6 +157,7 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
   int events = 0;
   // bitbuffer_t bits = {0};
   bitbuffer_clear(&bits);
+  pulse_classes_t const* classes = pulse_classes_get(pulses);
 
   int const gap_limit = s_gap ? s_gap : s_reset;
   int const max_zeros = gap_limit / s_long;
@@ -163,22 +236,39 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
   // NRZ pulse/gap of len 1 or 2 within tolerance anywhere
   int nrz_width = 0;
   int nrz_count = 0;
-  for (unsigned n = 0; preamble_len == 0 && s_short == s_long && n < pulses->num_pulses; ++n) {
-    if (pulses->pulse[n] >= s_short - s_tolerance && pulses->pulse[n] <= s_short + s_tolerance) {
-      nrz_width += pulses->pulse[n];
-      nrz_count += 1;
-    }
-    if (pulses->pulse[n] >= 2 * s_short - s_tolerance && pulses->pulse[n] <= 2 * s_short + s_tolerance) {
-      nrz_width += pulses->pulse[n];
-      nrz_count += 2;
+  int8_t pulse_nrz[PULSE_CLASSES_MAX];
+  int8_t gap_nrz[PULSE_CLASSES_MAX];
+  int const pulse_nrz_thresholds[] = {s_short - s_tolerance - 1, s_short + s_tolerance, 2 * s_short - s_tolerance - 1, 2 * s_short + s_tolerance};
+  int const gap_nrz_thresholds[] = {s_long - s_tolerance - 1, s_long + s_tolerance, 2 * s_long - s_tolerance - 1, 2 * s_long + s_tolerance};
+  int nrz_members = !classes; // some widths need to be tallied one by one
+  if (classes && preamble_len == 0 && s_short == s_long) {
+    // tally whole classes, members of classes that straddle a bound are tallied below
+    for (unsigned c = 0; c < classes->pulse_count; ++c) {
+      pulse_nrz[c] = pulse_class_uniform(&classes->pulse[c], pulse_nrz_thresholds, 4);
+      if (pulse_nrz[c])
+        nrz_tally_class(&classes->pulse[c], pulse_nrz_thresholds, &nrz_width, &nrz_count);
+      else
+        nrz_members = 1;
     }
-    if (pulses->gap[n] >= s_long - s_tolerance && pulses->gap[n] <= s_long + s_tolerance) {
-      nrz_width += pulses->gap[n];
-      nrz_count += 1;
+    for (unsigned c = 0; c < classes->gap_count; ++c) {
+      gap_nrz[c] = pulse_class_uniform(&classes->gap[c], gap_nrz_thresholds, 4);
+      if (gap_nrz[c])
+        nrz_tally_class(&classes->gap[c], gap_nrz_thresholds, &nrz_width, &nrz_count);
+      else
+        nrz_members = 1;
     }
-    if (pulses->gap[n] >= 2 * s_long - s_tolerance && pulses->gap[n] <= 2 * s_long + s_tolerance) {
-      nrz_width += pulses->gap[n];
-      nrz_count += 2;
+  }
+  for (unsigned n = 0; nrz_members && preamble_len == 0 && s_short == s_long && n < pulses->num_pulses; n += PULSE_KERNEL_BLOCK) {
+    uint8_t pulse_masks[PULSE_KERNEL_BLOCK];
+    uint8_t gap_masks[PULSE_KERNEL_BLOCK];
+    unsigned len = MIN(PULSE_KERNEL_BLOCK, pulses->num_pulses - n);
+    pulse_kernel_gt(&pulses->pulse[n], len, pulse_nrz_thresholds, 4, pulse_masks);
+    pulse_kernel_gt(&pulses->gap[n], len, gap_nrz_thresholds, 4, gap_masks);
+    for (unsigned k = 0; k < len; ++k) {
+      if (!classes || !pulse_nrz[classes->pulse_class[n + k]])
+        nrz_tally(pulses->pulse[n + k], pulse_masks[k], &nrz_width, &nrz_count);
+      if (!classes || !gap_nrz[classes->gap_class[n + k]])
+        nrz_tally(pulses->gap[n + k], gap_masks[k], &nrz_width, &nrz_count);
     }
   }
   // require at least 10 bits measured
@@ -191,12 +281,40 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
     }
   }
 
+  // bit periods are monotonic in the width, a class whose smallest and largest
+  // member give the same count gives that count for all members
+  int pulse_highs[PULSE_CLASSES_MAX];
+  int gap_lows[PULSE_CLASSES_MAX];
+  int8_t pulse_corrupt[PULSE_CLASSES_MAX];
+  // pulse is within tolerance if the mask is 0x1
+  int const corrupt_thresholds[] = {s_short - s_tolerance - 1, s_short + s_tolerance};
+  int corrupt_members = !classes && s_short != s_long;
+  for (unsigned c = 0; classes && c < classes->pulse_count; ++c) {
+    pulse_class_t const* pc = &classes->pulse[c];
+    int highs = pcm_highs(pc->min, f_short);
+    pulse_highs[c] = highs == pcm_highs(pc->max, f_short) ? highs : INT_MIN;
+    pulse_corrupt[c] = pulse_class_uniform(pc, corrupt_thresholds, 2) ? pulse_kernel_mask(pc->min, corrupt_thresholds, 2) != 0x1 : SYMBOL_UNKNOWN;
+    corrupt_members |= pulse_corrupt[c] == SYMBOL_UNKNOWN && s_short != s_long;
+  }
+  for (unsigned c = 0; classes && c < classes->gap_count; ++c) {
+    pulse_class_t const* gc = &classes->gap[c];
+    int lows = pcm_lows(gc->min, s_short, s_long, f_long);
+    gap_lows[c] = lows == pcm_lows(gc->max, s_short, s_long, f_long) ? lows : INT_MIN;
+  }
+
+  uint8_t corrupt_masks[PULSE_KERNEL_BLOCK];
   for (unsigned n = 0; n < pulses->num_pulses; ++n) {
+    if (corrupt_members && (n & (PULSE_KERNEL_BLOCK - 1)) == 0)
+      pulse_kernel_gt(&pulses->pulse[n], MIN(PULSE_KERNEL_BLOCK, pulses->num_pulses - n), corrupt_thresholds, 2, corrupt_masks);
     // Determine number of high bit periods for NRZ coding, where bits may not be separated
-    int highs = (pulses->pulse[n]) * f_short + 0.5;
+    int highs = classes ? pulse_highs[classes->pulse_class[n]] : INT_MIN;
+    if (highs == INT_MIN)
+      highs = pcm_highs(pulses->pulse[n], f_short);
     // Determine number of low bit periods in current gap length (rounded)
     // for RZ subtract the nominal bit-gap
-    int lows = (pulses->gap[n] + s_short - s_long) * f_long + 0.5;
+    int lows = classes ? gap_lows[classes->gap_class[n]] : INT_MIN;
+    if (lows == INT_MIN)
+      lows = pcm_lows(pulses->gap[n], s_short, s_long, f_long);
 
     // Add run of ones (1 for RZ, many for NRZ)
     for (int i = 0; i < highs; ++i) {
@@ -209,8 +327,11 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
     }
 
     // Validate data
+    int corrupt = classes ? pulse_corrupt[classes->pulse_class[n]] : SYMBOL_UNKNOWN;
+    if (corrupt == SYMBOL_UNKNOWN)
+      corrupt = corrupt_members ? corrupt_masks[n & (PULSE_KERNEL_BLOCK - 1)] != 0x1 : 0;
     if ((s_short != s_long) // Only for RZ coding
-        && (abs(pulses->pulse[n] - s_short) > s_tolerance)) { // Pulse must be within tolerance
+        && corrupt) { // Pulse must be within tolerance
 
       // Data is corrupt
       if (device->verbose > 3) {
@@ -237,22 +358,22 @@ int pulse_slicer_pcm(pulse_data_t const* pulses, r_device* device) {
   return events;
 }
 
-int pulse_slicer_ppm(pulse_data_t const* pulses, r_device* device) {
-  float samples_per_us = pulses->sample_rate / 1.0e6;
-
-  int s_short = device->short_width * samples_per_us;
-  int s_long = device->long_width * samples_per_us;
-  int s_reset = device->reset_limit * samples_per_us;
-  int s_gap = device->gap_limit * samples_per_us;
-  int s_sync = device->sync_width * samples_per_us;
-  int s_tolerance = device->tolerance * samples_per_us;
-
-  // check for rounding to zero
-  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
-    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
-    return 0;
-  }
+/// Classify a PPM gap mask against zero, one and sync lower and upper - 1 and reset - 1.
+static inline int ppm_symbol(unsigned mask) {
+  if ((mask & 0x03) == 0x01)
+    return SYMBOL_ZERO;
+  if ((mask & 0x0c) == 0x04)
+    return SYMBOL_ONE;
+  if ((mask & 0x30) == 0x10)
+    return SYMBOL_SYNC;
+  if (!(mask & 0x40))
+    return SYMBOL_ROW;
+  return SYMBOL_NONE;
+}
 
+/// PPM slicer with the widths in samples, inlined into the generic and the specialized slicers.
+static R_ALWAYS_INLINE int ppm_slice(pulse_data_t const* pulses, r_device* device,
+        int s_short, int s_long, int s_reset, int s_gap, int s_sync, int s_tolerance) {
   int events = 0;
   // bitbuffer_t bits = {0};
   bitbuffer_clear(&bits);
@@ -280,35 +401,51 @@ int pulse_slicer_ppm(pulse_data_t const* pulses, r_device* device) {
     one_u = s_gap ? s_gap : s_reset;
   }
 
+  int const thresholds[] = {zero_l, zero_u - 1, one_l, one_u - 1, sync_l, sync_u - 1, s_reset - 1};
+  pulse_classes_t const* classes = pulse_classes_get(pulses);
+  int8_t class_symbol[PULSE_CLASSES_MAX];
+  int members = !classes; // some gaps need to be classified one by one
+  for (unsigned c = 0; classes && c < classes->gap_count; ++c) {
+    pulse_class_t const* gc = &classes->gap[c];
+    class_symbol[c] = pulse_class_uniform(gc, thresholds, 7) ? ppm_symbol(pulse_kernel_mask(gc->min, thresholds, 7)) : SYMBOL_UNKNOWN;
+    members |= class_symbol[c] == SYMBOL_UNKNOWN;
+  }
+
+  uint8_t masks[PULSE_KERNEL_BLOCK];
   for (unsigned n = 0; n < pulses->num_pulses; ++n) {
-    if (pulses->gap[n] > zero_l && pulses->gap[n] < zero_u) {
-      // Short gap
+    if (members && (n & (PULSE_KERNEL_BLOCK - 1)) == 0)
+      pulse_kernel_gt(&pulses->gap[n], MIN(PULSE_KERNEL_BLOCK, pulses->num_pulses - n), thresholds, 7, masks);
+    int symbol = classes ? class_symbol[classes->gap_class[n]] : SYMBOL_UNKNOWN;
+    if (symbol == SYMBOL_UNKNOWN)
+      symbol = ppm_symbol(masks[n & (PULSE_KERNEL_BLOCK - 1)]);
+
+    switch (symbol) {
+    case SYMBOL_ZERO: // Short gap
       bitbuffer_add_bit(&bits, 0);
-    } else if (pulses->gap[n] > one_l && pulses->gap[n] < one_u) {
-      // Long gap
+      break;
+    case SYMBOL_ONE: // Long gap
       bitbuffer_add_bit(&bits, 1);
-    } else if (pulses->gap[n] > sync_l && pulses->gap[n] < sync_u) {
-      // Sync gap
+      break;
+    case SYMBOL_SYNC: // Sync gap
       bitbuffer_add_sync(&bits);
-    }
-
-    // Check for new packet in multipacket
-    else if (pulses->gap[n] < s_reset) {
+      break;
+    case SYMBOL_ROW: // Check for new packet in multipacket
       bitbuffer_add_row(&bits);
+      break;
     }
     // End of Message?
     if (((n == pulses->num_pulses - 1) // No more pulses? (FSK)
          || (pulses->gap[n] >= s_reset)) // Long silence (OOK)
         && (bits.bits_per_row[0] > 0 || bits.num_rows > 1)) { // Only if data has been accumulated
 
-      events += account_event(device, &bits, __func__);
+      events += account_event(device, &bits, "pulse_slicer_ppm");
       bitbuffer_clear(&bits);
     }
   } // for pulses
   return events;
 }
 
-int pulse_slicer_pwm(pulse_data_t const* pulses, r_device* device) {
+int pulse_slicer_ppm(pulse_data_t const* pulses, r_device* device) {
   float samples_per_us = pulses->sample_rate / 1.0e6;
 
   int s_short = device->short_width * samples_per_us;
@@ -318,15 +455,31 @@ int pulse_slicer_pwm(pulse_data_t const* pulses, r_device* device) {
   int s_sync = device->sync_width * samples_per_us;
   int s_tolerance = device->tolerance * samples_per_us;
 
-//  if (s_tolerance <= 0) // From https://github.com/NorthernMan54/rtl_433_ESP/pull/65
-//    s_tolerance = s_long / 4; // default tolerance is +-25% of a bit period
-
   // check for rounding to zero
   if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
     print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
     return 0;
   }
 
+  return ppm_slice(pulses, device, s_short, s_long, s_reset, s_gap, s_sync, s_tolerance);
+}
+
+/// Classify a PWM pulse mask against one, zero and sync lower and upper - 1.
+static inline int pwm_symbol(unsigned mask) {
+  if ((mask & 0x03) == 0x01)
+    return SYMBOL_ONE;
+  if ((mask & 0x0c) == 0x04)
+    return SYMBOL_ZERO;
+  if ((mask & 0x30) == 0x10)
+    return SYMBOL_SYNC;
+  if (!(mask & 0x01))
+    return SYMBOL_NONE;
+  return SYMBOL_ROW;
+}
+
+/// PWM slicer with the widths in samples, inlined into the generic and the specialized slicers.
+static R_ALWAYS_INLINE int pwm_slice(pulse_data_t const* pulses, r_device* device,
+        int s_short, int s_long, int s_reset, int s_gap, int s_sync, int s_tolerance) {
   int events = 0;
   // bitbuffer_t bits = {0};
   bitbuffer_clear(&bits);
@@ -378,28 +531,46 @@ int pulse_slicer_pwm(pulse_data_t const* pulses, r_device* device) {
     sync_u = INT_MAX;
   }
 
+  int const thresholds[] = {one_l, one_u - 1, zero_l, zero_u - 1, sync_l, sync_u - 1};
+  pulse_classes_t const* classes = pulse_classes_get(pulses);
+  int8_t class_symbol[PULSE_CLASSES_MAX];
+  int members = !classes; // some pulses need to be classified one by one
+  for (unsigned c = 0; classes && c < classes->pulse_count; ++c) {
+    pulse_class_t const* pc = &classes->pulse[c];
+    class_symbol[c] = pulse_class_uniform(pc, thresholds, 6) ? pwm_symbol(pulse_kernel_mask(pc->min, thresholds, 6)) : SYMBOL_UNKNOWN;
+    members |= class_symbol[c] == SYMBOL_UNKNOWN;
+  }
+
+  uint8_t masks[PULSE_KERNEL_BLOCK];
   for (unsigned n = 0; n < pulses->num_pulses; ++n) {
-    if (pulses->pulse[n] > one_l && pulses->pulse[n] < one_u) {
-      // 'Short' 1 pulse
+    if (members && (n & (PULSE_KERNEL_BLOCK - 1)) == 0)
+      pulse_kernel_gt(&pulses->pulse[n], MIN(PULSE_KERNEL_BLOCK, pulses->num_pulses - n), thresholds, 6, masks);
+    int symbol = classes ? class_symbol[classes->pulse_class[n]] : SYMBOL_UNKNOWN;
+    if (symbol == SYMBOL_UNKNOWN)
+      symbol = pwm_symbol(masks[n & (PULSE_KERNEL_BLOCK - 1)]);
+
+    switch (symbol) {
+    case SYMBOL_ONE: // 'Short' 1 pulse
       bitbuffer_add_bit(&bits, 1);
-    } else if (pulses->pulse[n] > zero_l && pulses->pulse[n] < zero_u) {
-      // 'Long' 0 pulse
+      break;
+    case SYMBOL_ZERO: // 'Long' 0 pulse
       bitbuffer_add_bit(&bits, 0);
-    } else if (pulses->pulse[n] > sync_l && pulses->pulse[n] < sync_u) {
-      // Sync pulse
+      break;
+    case SYMBOL_SYNC: // Sync pulse
       bitbuffer_add_sync(&bits);
-    } else if (pulses->pulse[n] <= one_l) {
-      // Ignore spurious short pulses
-    } else {
-      // Pulse outside specified timing
+      break;
+    case SYMBOL_NONE: // Ignore spurious short pulses
+      break;
+    default: // Pulse outside specified timing
       bitbuffer_add_row(&bits);
+      break;
     }
 
     // End of Message?
     if (((n == pulses->num_pulses - 1) // No more pulses? (FSK)
          || (pulses->gap[n] > s_reset)) // Long silence (OOK)
         && (bits.num_rows > 0)) { // Only if data has been accumulated
-      events += account_event(device, &bits, __func__);
+      events += account_event(device, &bits, "pulse_slicer_pwm");
       bitbuffer_clear(&bits);
     } else if (s_gap > 0 && pulses->gap[n] > s_gap && bits.num_rows > 0 && bits.bits_per_row[bits.num_rows - 1] > 0) {
       // New packet in multipacket
@@ -409,6 +580,28 @@ int pulse_slicer_pwm(pulse_data_t const* pulses, r_device* device) {
   return events;
 }
 
+int pulse_slicer_pwm(pulse_data_t const* pulses, r_device* device) {
+  float samples_per_us = pulses->sample_rate / 1.0e6;
+
+  int s_short = device->short_width * samples_per_us;
+  int s_long = device->long_width * samples_per_us;
+  int s_reset = device->reset_limit * samples_per_us;
+  int s_gap = device->gap_limit * samples_per_us;
+  int s_sync = device->sync_width * samples_per_us;
+  int s_tolerance = device->tolerance * samples_per_us;
+
+//  if (s_tolerance <= 0) // From https://github.com/NorthernMan54/rtl_433_ESP/pull/65
+//    s_tolerance = s_long / 4; // default tolerance is +-25% of a bit period
+
+  // check for rounding to zero
+  if ((device->short_width > 0 && s_short <= 0) || (device->long_width > 0 && s_long <= 0) || (device->reset_limit > 0 && s_reset <= 0) || (device->gap_limit > 0 && s_gap <= 0) || (device->sync_width > 0 && s_sync <= 0) || (device->tolerance > 0 && s_tolerance <= 0)) {
+    print_logf(LOG_WARNING, __func__, "sample rate too low for protocol %u \"%s\"", device->protocol_num, device->name);
+    return 0;
+  }
+
+  return pwm_slice(pulses, device, s_short, s_long, s_reset, s_gap, s_sync, s_tolerance);
+}
+
 int pulse_slicer_manchester_zerobit(pulse_data_t const* pulses, r_device* device) {
   float samples_per_us = pulses->sample_rate / 1.0e6;
 
@@ -769,6 +962,60 @@ int pulse_slicer_osv1(pulse_data_t const* pulses, r_device* device) {
   return events;
 }
 
+#ifdef SPECIALIZED_SLICERS
+#include "pulse_slicer_fixed.h"
+
+#define SLICER_SAMPLES(width) ((int)(float)(width))
+#define SLICER_ROUNDS_TO_ZERO(width) ((width) > 0 && SLICER_SAMPLES(width) <= 0)
+
+// The widths fold into the thresholds, the generic slicer logs rounding to zero.
+#define SLICER(index, modulation, short_width, long_width, reset_limit, gap_limit, sync_width, tolerance) \
+  static int pulse_slicer_fixed_##index(pulse_data_t const* pulses, r_device* device) { \
+    int generic = pulses->sample_rate != 1000000 || SLICER_ROUNDS_TO_ZERO(short_width) || SLICER_ROUNDS_TO_ZERO(long_width) \
+        || SLICER_ROUNDS_TO_ZERO(reset_limit) || SLICER_ROUNDS_TO_ZERO(gap_limit) || SLICER_ROUNDS_TO_ZERO(sync_width) \
+        || SLICER_ROUNDS_TO_ZERO(tolerance); \
+    if (modulation == OOK_PULSE_PPM) \
+      return generic ? pulse_slicer_ppm(pulses, device) : ppm_slice(pulses, device, SLICER_SAMPLES(short_width), \
+          SLICER_SAMPLES(long_width), SLICER_SAMPLES(reset_limit), SLICER_SAMPLES(gap_limit), SLICER_SAMPLES(sync_width), \
+          SLICER_SAMPLES(tolerance)); \
+    return generic ? pulse_slicer_pwm(pulses, device) : pwm_slice(pulses, device, SLICER_SAMPLES(short_width), \
+        SLICER_SAMPLES(long_width), SLICER_SAMPLES(reset_limit), SLICER_SAMPLES(gap_limit), SLICER_SAMPLES(sync_width), \
+        SLICER_SAMPLES(tolerance)); \
+  }
+PULSE_SLICER_FIXED
+#undef SLICER
+
+static struct {
+  unsigned modulation;
+  float short_width;
+  float long_width;
+  float reset_limit;
+  float gap_limit;
+  float sync_width;
+  float tolerance;
+  int (*slicer_fn)(pulse_data_t const* pulses, r_device* device);
+} const slicer_fixed[] = {
+#define SLICER(index, modulation, short_width, long_width, reset_limit, gap_limit, sync_width, tolerance) \
+  {modulation, short_width, long_width, reset_limit, gap_limit, sync_width, tolerance, pulse_slicer_fixed_##index},
+    PULSE_SLICER_FIXED
+#undef SLICER
+};
+
+int (*pulse_slicer_fixed(r_device const* device))(pulse_data_t const* pulses, r_device* device) {
+  for (unsigned i = 0; i < sizeof(slicer_fixed) / sizeof(*slicer_fixed); ++i) {
+    if (slicer_fixed[i].modulation == device->modulation
+        && slicer_fixed[i].short_width == device->short_width
+        && slicer_fixed[i].long_width == device->long_width
+        && slicer_fixed[i].reset_limit == device->reset_limit
+        && slicer_fixed[i].gap_limit == device->gap_limit
+        && slicer_fixed[i].sync_width == device->sync_width
+        && slicer_fixed[i].tolerance == device->tolerance)
+      return slicer_fixed[i].slicer_fn;
+  }
+  return NULL;
+}
+#endif
+
 int pulse_slicer_string(const char* code, r_device* device) {
   int events = 0;
   bitbuffer_t bits = {0};
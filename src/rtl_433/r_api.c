@@ -20,8 +20,11 @@
 #include <string.h>
 
 #include "pulse_slicer.h"
+#include "r_convert.h"
 #include "r_device.h"
+#include "r_filter.h"
 #include "r_private.h"
+#include "r_schedule.h"
 #include "r_util.h"
 #include "rtl_433.h"
 #include "rtl_433_devices.h"
@@ -45,6 +48,12 @@
 // #include "sdr.h"
 // #include "write_sigrok.h"
 #include "log.h"
+#include "trace.h"
+#ifdef DECODER_PROFILE
+#  include "freertos/FreeRTOS.h"
+#  include "freertos/task.h"
+#  include "stack_profile.h"
+#endif
 
 #ifdef _WIN32
 #  include <fcntl.h>
@@ -202,52 +211,73 @@ r_cfg_t* r_create_cfg(void) {
   return cfg;
 }
 
-/*
-void r_free_cfg(r_cfg_t *cfg) {
-  if (cfg->dev) {
-    sdr_deactivate(cfg->dev);
-    sdr_close(cfg->dev);
-  }
-
-  free(cfg->gain_str);
-
-  for (void **iter = cfg->demod->dumper.elems; iter && *iter; ++iter) {
-    file_info_t const *dumper = *iter;
-    if (dumper->file && (dumper->file != stdout))
-      fclose(dumper->file);
-  }
-  list_free_elems(&cfg->demod->dumper, free);
-
+// only what this port allocates, no SDR, dumpers or analyzers
+void r_free_cfg(r_cfg_t* cfg) {
   list_free_elems(&cfg->demod->r_devs, (list_elem_free_fn)free_protocol);
 
-  if (cfg->demod->am_analyze)
-    am_analyze_free(cfg->demod->am_analyze);
-
-  pulse_detect_free(cfg->demod->pulse_detect);
-
-//  list_free_elems(&cfg->raw_handler, (list_elem_free_fn)raw_output_free);
-
-  r_logger_set_log_handler(NULL, NULL);
-
   list_free_elems(&cfg->output_handler, (list_elem_free_fn)data_output_free);
 
-//  list_free_elems(&cfg->data_tags, (list_elem_free_fn)data_tag_free);
-
-  list_free_elems(&cfg->in_files, NULL);
+  r_filter_free(cfg);
 
   free(cfg->demod);
-
-  free(cfg->devices);
-
-  mg_mgr_free(cfg->mgr);
-  free(cfg->mgr);
+  cfg->demod = NULL;
 
   // free(cfg);
 }
-*/
 
 /* device decoder protocols */
 
+/// Highest level any log output takes, 0 without log outputs.
+static int log_output_level(r_cfg_t* cfg) {
+  int level = 0;
+  for (size_t i = 0; i < cfg->output_handler.len; ++i) {
+    data_output_t* output = cfg->output_handler.elems[i];
+    if (output && output->log_level > level)
+      level = output->log_level;
+  }
+  return level;
+}
+
+#ifdef SHARED_SLICES
+/// Decoders slicing the pulses alike, see bitbuffer_view.h.
+static int same_slicing(r_device const* a, r_device const* b) {
+  return a->modulation == b->modulation && a->priority == b->priority
+      && a->short_width == b->short_width && a->long_width == b->long_width
+      && a->reset_limit == b->reset_limit && a->gap_limit == b->gap_limit
+      && a->sync_width == b->sync_width && a->tolerance == b->tolerance;
+}
+
+/// Append a new decoder to the slice group of the first earlier decoder slicing alike.
+static void slice_group_join(r_cfg_t* cfg, r_device* p) {
+  p->slice_next = NULL;
+  p->slice_follower = 0;
+  p->slice_skip = 0;
+  list_t* r_devs = &cfg->demod->r_devs;
+  for (size_t i = 0; i + 1 < r_devs->len; ++i) {
+    r_device* leader = r_devs->elems[i];
+    if (leader->slice_follower || !same_slicing(leader, p))
+      continue;
+    r_device* last = leader;
+    while (last->slice_next)
+      last = last->slice_next;
+    last->slice_next = p;
+    p->slice_follower = 1;
+    return;
+  }
+}
+
+/// Mark the decoders of a slice group removed by the message filter or run
+/// by the schedule already, 0 if all are.
+static int slice_group_filter(r_device* leader) {
+  int wanted = 0;
+  for (r_device* r_dev = leader; r_dev; r_dev = r_dev->slice_next) {
+    r_dev->slice_skip = r_dev->schedule_tried || !r_filter_decoder(((r_cfg_t*)r_dev->output_ctx)->filter, r_dev->protocol_num);
+    wanted |= !r_dev->slice_skip;
+  }
+  return wanted;
+}
+#endif
+
 void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
   // use arg of 'v', 'vv', 'vvv' as device verbosity
   int dev_verbose = 0;
@@ -277,12 +307,22 @@ void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
 
   p->verbose = dev_verbose ? dev_verbose : (cfg->verbosity > 4 ? cfg->verbosity - 5 : 0);
 
-  p->log_fn = log_device_handler;
+  // decoder levels start at LOG_WARNING, without an output taking them no log
+  // records are built, e.g. in the host tools.  The device log output takes
+  // all levels, there records up to the decoder verbosity are built
+  p->log_fn = log_output_level(cfg) >= LOG_WARNING ? log_device_handler : NULL;
+  p->convert = r_convert_plan(p, cfg->conversion_mode);
+#ifdef SPECIALIZED_SLICERS
+  p->slicer_fn = pulse_slicer_fixed(p);
+#endif
 
   p->output_fn = data_acquired_handler;
   p->output_ctx = cfg;
 
   list_push(&cfg->demod->r_devs, p);
+#ifdef SHARED_SLICES
+  slice_group_join(cfg, p);
+#endif
 
   if (cfg->verbosity >= LOG_INFO) {
     fprintf(stderr, "Registering protocol [%u] \"%s\"\n", r_dev->protocol_num,
@@ -290,13 +330,14 @@ void register_protocol(r_cfg_t* cfg, r_device* r_dev, char* arg) {
   }
 }
 
-/*
-void free_protocol(r_device *r_dev) {
+void free_protocol(r_device* r_dev) {
   // free(r_dev->name);
+  r_convert_free(r_dev->convert);
   free(r_dev->decode_ctx);
   free(r_dev);
 }
 
+/*
 void unregister_protocol(r_cfg_t *cfg, r_device *r_dev) {
   for (size_t i = 0; i < cfg->demod->r_devs.len;
        ++i) { // list might contain NULLs
@@ -510,8 +551,127 @@ char const **determine_csv_fields(r_cfg_t *cfg, char const *const *well_known,
 
 */
 
+int run_ook_demod(r_device* r_dev, pulse_data_t* pulse_data) {
+  int p_events = 0;
+  TRACE(TRACE_DEMOD_BEGIN, r_dev->protocol_num);
+  switch (r_dev->modulation) {
+    case OOK_PULSE_PCM:
+      // case OOK_PULSE_RZ:
+      p_events += pulse_slicer_pcm(pulse_data, r_dev);
+      break;
+    case OOK_PULSE_PPM:
+#ifdef SPECIALIZED_SLICERS
+      if (r_dev->slicer_fn) {
+        p_events += r_dev->slicer_fn(pulse_data, r_dev);
+        break;
+      }
+#endif
+      p_events += pulse_slicer_ppm(pulse_data, r_dev);
+      break;
+    case OOK_PULSE_PWM:
+#ifdef SPECIALIZED_SLICERS
+      if (r_dev->slicer_fn) {
+        p_events += r_dev->slicer_fn(pulse_data, r_dev);
+        break;
+      }
+#endif
+      p_events += pulse_slicer_pwm(pulse_data, r_dev);
+      break;
+    case OOK_PULSE_MANCHESTER_ZEROBIT:
+      p_events += pulse_slicer_manchester_zerobit(pulse_data, r_dev);
+      break;
+    case OOK_PULSE_PIWM_RAW:
+      p_events += pulse_slicer_piwm_raw(pulse_data, r_dev);
+      break;
+    case OOK_PULSE_PIWM_DC:
+      p_events += pulse_slicer_piwm_dc(pulse_data, r_dev);
+      break;
+    case OOK_PULSE_DMC:
+      p_events += pulse_slicer_dmc(pulse_data, r_dev);
+      break;
+    case OOK_PULSE_PWM_OSV1:
+      p_events += pulse_slicer_osv1(pulse_data, r_dev);
+      break;
+    case OOK_PULSE_NRZS:
+      p_events += pulse_slicer_nrzs(pulse_data, r_dev);
+      break;
+    // FSK decoders
+    case FSK_PULSE_PCM:
+    case FSK_PULSE_PWM:
+    case FSK_PULSE_MANCHESTER_ZEROBIT:
+      break;
+    default:
+      fprintf(stderr, "Unknown modulation %u in protocol!\n",
+              r_dev->modulation);
+  }
+  TRACE(TRACE_DEMOD_END, p_events);
+  return p_events;
+}
+
+int run_fsk_demod(r_device* r_dev, pulse_data_t* fsk_pulse_data) {
+  int p_events = 0;
+  TRACE(TRACE_DEMOD_BEGIN, r_dev->protocol_num);
+  switch (r_dev->modulation) {
+    // OOK decoders
+    case OOK_PULSE_PCM:
+    // case OOK_PULSE_RZ:
+    case OOK_PULSE_PPM:
+    case OOK_PULSE_PWM:
+    case OOK_PULSE_MANCHESTER_ZEROBIT:
+    case OOK_PULSE_PIWM_RAW:
+    case OOK_PULSE_PIWM_DC:
+    case OOK_PULSE_DMC:
+    case OOK_PULSE_PWM_OSV1:
+    case OOK_PULSE_NRZS:
+      break;
+    case FSK_PULSE_PCM:
+      p_events += pulse_slicer_pcm(fsk_pulse_data, r_dev);
+      break;
+    case FSK_PULSE_PWM:
+#ifdef SPECIALIZED_SLICERS
+      if (r_dev->slicer_fn) {
+        p_events += r_dev->slicer_fn(fsk_pulse_data, r_dev);
+        break;
+      }
+#endif
+      p_events += pulse_slicer_pwm(fsk_pulse_data, r_dev);
+      break;
+    case FSK_PULSE_MANCHESTER_ZEROBIT:
+      p_events += pulse_slicer_manchester_zerobit(fsk_pulse_data, r_dev);
+      break;
+    default:
+      fprintf(stderr, "Unknown modulation %u in protocol!\n",
+              r_dev->modulation);
+  }
+  TRACE(TRACE_DEMOD_END, p_events);
+  return p_events;
+}
+
+#ifdef DECODER_PROFILE
+/// Run a demod on a freshly painted stack and keep the deepest stack use.
+static int profile_demod(int (*demod)(r_device*, pulse_data_t*), r_device* r_dev, pulse_data_t* pulse_data) {
+  uint8_t marker;
+  uint8_t* lo = pxTaskGetStackStart(NULL);
+  uint8_t* hi = (uint8_t*)((uintptr_t)&marker - STACK_PROFILE_GUARD);
+  uint8_t* top = ((r_cfg_t*)r_dev->output_ctx)->profile_top;
+  stack_profile_paint(lo, hi);
+  int events = demod(r_dev, pulse_data);
+  // the unpainted guard is counted as used, and the frames of the callers
+  // down from the decoder task
+  unsigned depth = stack_profile_depth(lo, hi) + STACK_PROFILE_GUARD;
+  if (top > &marker)
+    depth += top - &marker;
+  if (depth > r_dev->profile_stack)
+    r_dev->profile_stack = depth;
+  return events;
+}
+#endif
+
 int run_ook_demods(list_t* r_devs, pulse_data_t* pulse_data) {
   int p_events = 0;
+#if defined(SHARED_SLICES) && !defined(DECODER_PROFILE)
+  pulse_slicer_share_slices(1);
+#endif
 
   unsigned next_priority = 0; // next smallest on each loop through decoders
   // run all decoders of each priority, stop if an event is produced
@@ -527,6 +687,15 @@ int run_ook_demods(list_t* r_devs, pulse_data_t* pulse_data) {
       // Run only current priority
       if (r_dev->priority != priority)
         continue;
+#if defined(SHARED_SLICES) && !defined(DECODER_PROFILE)
+      // Followers decode the slices of their leader, skip groups removed by the message filter
+      if (r_dev->slice_follower || !slice_group_filter(r_dev))
+        continue;
+#else
+      // Skip protocols removed by the message filter or run by the schedule already
+      if (r_dev->schedule_tried || !r_filter_decoder(((r_cfg_t*)r_dev->output_ctx)->filter, r_dev->protocol_num))
+        continue;
+#endif
 #ifdef RTL_DEBUG
         // logprintfLn(LOG_DEBUG, "demod(%d) - %s", r_dev->modulation, r_dev->name);
 #endif
@@ -534,44 +703,11 @@ int run_ook_demods(list_t* r_devs, pulse_data_t* pulse_data) {
       int preStack = uxTaskGetStackHighWaterMark(NULL);
 #endif
 
-      switch (r_dev->modulation) {
-        case OOK_PULSE_PCM:
-          // case OOK_PULSE_RZ:
-          p_events += pulse_slicer_pcm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PPM:
-          p_events += pulse_slicer_ppm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PWM:
-          p_events += pulse_slicer_pwm(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_MANCHESTER_ZEROBIT:
-          p_events += pulse_slicer_manchester_zerobit(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PIWM_RAW:
-          p_events += pulse_slicer_piwm_raw(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PIWM_DC:
-          p_events += pulse_slicer_piwm_dc(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_DMC:
-          p_events += pulse_slicer_dmc(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_PWM_OSV1:
-          p_events += pulse_slicer_osv1(pulse_data, r_dev);
-          break;
-        case OOK_PULSE_NRZS:
-          p_events += pulse_slicer_nrzs(pulse_data, r_dev);
-          break;
-        // FSK decoders
-        case FSK_PULSE_PCM:
-        case FSK_PULSE_PWM:
-        case FSK_PULSE_MANCHESTER_ZEROBIT:
-          break;
-        default:
-          fprintf(stderr, "Unknown modulation %u in protocol!\n",
-                  r_dev->modulation);
-      }
+#ifdef DECODER_PROFILE
+      p_events += profile_demod(run_ook_demod, r_dev, pulse_data);
+#else
+      p_events += run_ook_demod(r_dev, pulse_data);
+#endif
 #ifdef RESOURCE_DEBUG
       int delta = preStack - uxTaskGetStackHighWaterMark(NULL);
       if (delta) {
@@ -587,12 +723,18 @@ int run_ook_demods(list_t* r_devs, pulse_data_t* pulse_data) {
 #endif
     }
   }
+#if defined(SHARED_SLICES) && !defined(DECODER_PROFILE)
+  pulse_slicer_share_slices(0);
+#endif
 
   return p_events;
 }
 
 int run_fsk_demods(list_t* r_devs, pulse_data_t* fsk_pulse_data) {
   int p_events = 0;
+#if defined(SHARED_SLICES) && !defined(DECODER_PROFILE)
+  pulse_slicer_share_slices(1);
+#endif
 
   unsigned next_priority = 0; // next smallest on each loop through decoders
   // run all decoders of each priority, stop if an event is produced
@@ -608,6 +750,15 @@ int run_fsk_demods(list_t* r_devs, pulse_data_t* fsk_pulse_data) {
       // Run only current priority
       if (r_dev->priority != priority)
         continue;
+#if defined(SHARED_SLICES) && !defined(DECODER_PROFILE)
+      // Followers decode the slices of their leader, skip groups removed by the message filter
+      if (r_dev->slice_follower || !slice_group_filter(r_dev))
+        continue;
+#else
+      // Skip protocols removed by the message filter or run by the schedule already
+      if (r_dev->schedule_tried || !r_filter_decoder(((r_cfg_t*)r_dev->output_ctx)->filter, r_dev->protocol_num))
+        continue;
+#endif
 
 #ifdef RTL_DEBUG
         // logprintfLn(LOG_DEBUG, "demod(%d) - %s", r_dev->modulation, r_dev->name);
@@ -615,32 +766,11 @@ int run_fsk_demods(list_t* r_devs, pulse_data_t* fsk_pulse_data) {
 #ifdef RESOURCE_DEBUG
       int preStack = uxTaskGetStackHighWaterMark(NULL);
 #endif
-      switch (r_dev->modulation) {
-        // OOK decoders
-        case OOK_PULSE_PCM:
-        // case OOK_PULSE_RZ:
-        case OOK_PULSE_PPM:
-        case OOK_PULSE_PWM:
-        case OOK_PULSE_MANCHESTER_ZEROBIT:
-        case OOK_PULSE_PIWM_RAW:
-        case OOK_PULSE_PIWM_DC:
-        case OOK_PULSE_DMC:
-        case OOK_PULSE_PWM_OSV1:
-        case OOK_PULSE_NRZS:
-          break;
-        case FSK_PULSE_PCM:
-          p_events += pulse_slicer_pcm(fsk_pulse_data, r_dev);
-          break;
-        case FSK_PULSE_PWM:
-          p_events += pulse_slicer_pwm(fsk_pulse_data, r_dev);
-          break;
-        case FSK_PULSE_MANCHESTER_ZEROBIT:
-          p_events += pulse_slicer_manchester_zerobit(fsk_pulse_data, r_dev);
-          break;
-        default:
-          fprintf(stderr, "Unknown modulation %u in protocol!\n",
-                  r_dev->modulation);
-      }
+#ifdef DECODER_PROFILE
+      p_events += profile_demod(run_fsk_demod, r_dev, fsk_pulse_data);
+#else
+      p_events += run_fsk_demod(r_dev, fsk_pulse_data);
+#endif
 #ifdef RESOURCE_DEBUG
       int delta = preStack - uxTaskGetStackHighWaterMark(NULL);
       if (delta) {
@@ -650,6 +780,9 @@ int run_fsk_demods(list_t* r_devs, pulse_data_t* fsk_pulse_data) {
 #endif
     }
   }
+#if defined(SHARED_SLICES) && !defined(DECODER_PROFILE)
+  pulse_slicer_share_slices(0);
+#endif
 
   return p_events;
 }
@@ -716,7 +849,7 @@ void event_occurred_handler(r_cfg_t *cfg, data_t *data) {
 }
 */
 
-/** Pass the data structure to all output handlers. Frees data afterwards. */
+/** Pass a decoder log record to the log outputs of its level. Frees data afterwards. */
 
 void log_device_handler(r_device* r_dev, int level, data_t* data) {
   r_cfg_t* cfg = r_dev->output_ctx;
@@ -739,11 +872,21 @@ void log_device_handler(r_device* r_dev, int level, data_t* data) {
   data_free(data);
 }
 
-/** Pass the data structure to all output handlers. Frees data afterwards. */
+/** Filter, convert and pass a decoded message to the callback. Frees data afterwards. */
 
 void data_acquired_handler(r_device* r_dev, data_t* data) {
   r_cfg_t* cfg = r_dev->output_ctx;
 
+  // drop filtered messages before any conversion or output work
+  if (!r_filter_data(cfg, data)) {
+    data_free(data);
+    return;
+  }
+
+  // learn the transmission schedule of the device
+  if (cfg->schedule)
+    r_schedule_message(cfg->schedule, r_dev, data);
+
 #ifndef NDEBUG
   // check for undeclared csv fields
   for (data_t* d = data; d; d = d->next) {
@@ -761,160 +904,8 @@ void data_acquired_handler(r_device* r_dev, data_t* data) {
   }
 #endif
 
-  if (cfg->conversion_mode == CONVERT_SI) {
-    for (data_t* d = data; d; d = d->next) {
-      // Convert double type fields ending in _F to _C
-      if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_F")) {
-        d->value.v_dbl = fahrenheit2celsius(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_F", "_C");
-        free(d->key);
-        d->key = new_label;
-        char* pos;
-        if (d->format && (pos = strrchr(d->format, 'F'))) {
-          *pos = 'C';
-        }
-      }
-      // Convert double type fields ending in _mph to _kph
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_mph")) {
-        d->value.v_dbl = mph2kmph(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_mph", "_kph");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "mi/h", "km/h");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _mi_h to _km_h
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_mi_h")) {
-        d->value.v_dbl = mph2kmph(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_mi_h", "_km_h");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "mi/h", "km/h");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _in to _mm
-      else if ((d->type == DATA_DOUBLE) &&
-               (str_endswith(d->key, "_in") || str_endswith(d->key, "_inch"))) {
-        d->value.v_dbl = inch2mm(d->value.v_dbl);
-        // need to free ptr returned from str_replace
-        char* new_label1 = str_replace(d->key, "_inch", "_in");
-        char* new_label2 = str_replace(new_label1, "_in", "_mm");
-        free(new_label1);
-        free(d->key);
-        d->key = new_label2;
-        char* new_format_label = str_replace(d->format, "in", "mm");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _in_h to _mm_h
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_in_h")) {
-        d->value.v_dbl = inch2mm(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_in_h", "_mm_h");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "in/h", "mm/h");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _inHg to _hPa
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_inHg")) {
-        d->value.v_dbl = inhg2hpa(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_inHg", "_hPa");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "inHg", "hPa");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _PSI to _kPa
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_PSI")) {
-        d->value.v_dbl = psi2kpa(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_PSI", "_kPa");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "PSI", "kPa");
-        free(d->format);
-        d->format = new_format_label;
-      }
-    }
-  }
-  if (cfg->conversion_mode == CONVERT_CUSTOMARY) {
-    for (data_t* d = data; d; d = d->next) {
-      // Convert double type fields ending in _C to _F
-      if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_C")) {
-        d->value.v_dbl = celsius2fahrenheit(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_C", "_F");
-        free(d->key);
-        d->key = new_label;
-        char* pos;
-        if (d->format && (pos = strrchr(d->format, 'C'))) {
-          *pos = 'F';
-        }
-      }
-      // Convert double type fields ending in _kph to _mph
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_kph")) {
-        d->value.v_dbl = kmph2mph(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_kph", "_mph");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "km/h", "mi/h");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _km_h to _mi_h
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_km_h")) {
-        d->value.v_dbl = kmph2mph(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_km_h", "_mi_h");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "km/h", "mi/h");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _mm to _inch
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_mm")) {
-        d->value.v_dbl = mm2inch(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_mm", "_in");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "mm", "in");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _mm_h to _in_h
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_mm_h")) {
-        d->value.v_dbl = mm2inch(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_mm_h", "_in_h");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "mm/h", "in/h");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _hPa to _inHg
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_hPa")) {
-        d->value.v_dbl = hpa2inhg(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_hPa", "_inHg");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "hPa", "inHg");
-        free(d->format);
-        d->format = new_format_label;
-      }
-      // Convert double type fields ending in _kPa to _PSI
-      else if ((d->type == DATA_DOUBLE) && str_endswith(d->key, "_kPa")) {
-        d->value.v_dbl = kpa2psi(d->value.v_dbl);
-        char* new_label = str_replace(d->key, "_kPa", "_PSI");
-        free(d->key);
-        d->key = new_label;
-        char* new_format_label = str_replace(d->format, "kPa", "PSI");
-        free(d->format);
-        d->format = new_format_label;
-      }
-    }
-  }
+  // convert the declared fields by the plan made at registration
+  r_convert_data(r_dev, cfg->conversion_mode, data);
 
   /*
     // prepend "description" if requested
@@ -967,24 +958,40 @@ void data_acquired_handler(r_device* r_dev, data_t* data) {
 
 */
 
-  for (size_t i = 0; i < cfg->output_handler.len;
-       ++i) { // list might contain NULLs
-    data_output_t* output = cfg->output_handler.elems[i];
-    data_output_print(output, data);
-  }
-
+  // decoded messages go straight to the callback, cfg->output_handler only holds log outputs
   data_append(data, "protocol", "", DATA_STRING, r_dev->name, "rssi", "RSSI",
               DATA_INT, cfg->demod->pulse_data.signalRssi, "duration", "",
               DATA_INT, cfg->demod->pulse_data.signalDuration, NULL);
-  data_print_jsons(data, cfg->messageBuffer, cfg->bufferSize);
+  r_output_message(cfg, data);
+  data_free(data);
+}
+
+void r_output_message(r_cfg_t* cfg, data_t* data) {
+  if (cfg->typed_callback && cfg->encoding == R_ENCODING_CBOR) {
+    size_t len = data_print_cbor(data, (unsigned char*)cfg->messageBuffer, cfg->bufferSize);
+    if (!len) {
+      print_logf(LOG_WARNING, "r_output_message", "message does not fit into %d bytes", cfg->bufferSize);
+      return;
+    }
+    TRACE(TRACE_CALLBACK_BEGIN, len);
+    cfg->typed_callback((uint8_t const*)cfg->messageBuffer, len, R_ENCODING_CBOR);
+    TRACE(TRACE_CALLBACK_END, 0);
+    return;
+  }
+
+  size_t len = data_print_jsons(data, cfg->messageBuffer, cfg->bufferSize);
 #ifdef DEMOD_DEBUG
   logprintfLn(LOG_INFO, "data_output %s", cfg->messageBuffer);
 #endif
 
   // callback to external function that receives message from device (
   // rtl_433_ESPCallBack )
-  (cfg->callback)(cfg->messageBuffer);
-  data_free(data);
+  TRACE(TRACE_CALLBACK_BEGIN, len);
+  if (cfg->typed_callback)
+    cfg->typed_callback((uint8_t const*)cfg->messageBuffer, len, R_ENCODING_JSON);
+  else
+    (cfg->callback)(cfg->messageBuffer);
+  TRACE(TRACE_CALLBACK_END, 0);
 }
 
 // level 0: do not report (don't call this), 1: report successful devices, 2:
@@ -1153,6 +1160,13 @@ void add_log_output(r_cfg_t* cfg, char* param) {
   int log_level = lvlarg_param(&param, LOG_TRACE);
   list_push(&cfg->output_handler,
             data_output_log_create(log_level, fopen_output(param)));
+  // decoders registered before the output take its records now
+  if (cfg->demod && log_level >= LOG_WARNING) {
+    for (void** iter = cfg->demod->r_devs.elems; iter && *iter; ++iter) {
+      r_device* r_dev = *iter;
+      r_dev->log_fn = log_device_handler;
+    }
+  }
 }
 
 /*
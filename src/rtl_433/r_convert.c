@@ -0,0 +1,171 @@
+/** @file
+    Unit conversion plans of the decoders.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "r_convert.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "data.h"
+#include "fatal.h"
+#include "r_device.h"
+#include "r_util.h"
+#include "rtl_433.h"
+
+/// A conversion of a key suffix, unit is replaced in the format.
+/// A unit of NULL replaces the last 'F' or 'C' of the format.
+typedef struct unit_conversion {
+  conversion_mode_t mode;
+  char const* suffix;
+  char const* new_suffix;
+  char const* unit;
+  char const* new_unit;
+  float (*convert)(float value);
+} unit_conversion_t;
+
+// in the order of the suffix checks the conversions replaced
+static unit_conversion_t const conversions[] = {
+    {CONVERT_SI, "_F", "_C", NULL, NULL, fahrenheit2celsius},
+    {CONVERT_SI, "_mph", "_kph", "mi/h", "km/h", mph2kmph},
+    {CONVERT_SI, "_mi_h", "_km_h", "mi/h", "km/h", mph2kmph},
+    {CONVERT_SI, "_in", "_mm", "in", "mm", inch2mm},
+    {CONVERT_SI, "_inch", "_mm", "in", "mm", inch2mm},
+    {CONVERT_SI, "_in_h", "_mm_h", "in/h", "mm/h", inch2mm},
+    {CONVERT_SI, "_inHg", "_hPa", "inHg", "hPa", inhg2hpa},
+    {CONVERT_SI, "_PSI", "_kPa", "PSI", "kPa", psi2kpa},
+    {CONVERT_CUSTOMARY, "_C", "_F", NULL, NULL, celsius2fahrenheit},
+    {CONVERT_CUSTOMARY, "_kph", "_mph", "km/h", "mi/h", kmph2mph},
+    {CONVERT_CUSTOMARY, "_km_h", "_mi_h", "km/h", "mi/h", kmph2mph},
+    {CONVERT_CUSTOMARY, "_mm", "_in", "mm", "in", mm2inch},
+    {CONVERT_CUSTOMARY, "_mm_h", "_in_h", "mm/h", "in/h", mm2inch},
+    {CONVERT_CUSTOMARY, "_hPa", "_inHg", "hPa", "inHg", hpa2inhg},
+    {CONVERT_CUSTOMARY, "_kPa", "_PSI", "kPa", "PSI", kpa2psi},
+};
+#define NUM_CONVERSIONS (sizeof(conversions) / sizeof(*conversions))
+
+static r_convert_t empty_plans[3] = {{CONVERT_NATIVE, 0}, {CONVERT_SI, 0}, {CONVERT_CUSTOMARY, 0}};
+
+/// Conversion of a declared field, -1 for none.
+static int field_conversion(char const* key, int mode) {
+  for (unsigned i = 0; i < NUM_CONVERSIONS; ++i) {
+    if ((int)conversions[i].mode == mode && str_endswith(key, conversions[i].suffix))
+      return i;
+  }
+  return -1;
+}
+
+/// The new name as the suffix replacement did it, every occurrence is replaced.
+static char* field_new_key(char const* key, unit_conversion_t const* c) {
+  if (!strcmp(c->suffix, "_in") || !strcmp(c->suffix, "_inch")) {
+    char* in = str_replace(key, "_inch", "_in");
+    char* new_key = in ? str_replace(in, "_in", c->new_suffix) : NULL;
+    free(in);
+    return new_key;
+  }
+  return str_replace(key, c->suffix, c->new_suffix);
+}
+
+r_convert_t* r_convert_plan(r_device const* r_dev, int mode) {
+  if (mode < CONVERT_NATIVE || mode > CONVERT_CUSTOMARY)
+    mode = CONVERT_NATIVE;
+  unsigned count = 0;
+  for (char const* const* p = r_dev->fields; mode != CONVERT_NATIVE && p && *p; ++p) {
+    if (field_conversion(*p, mode) >= 0)
+      count++;
+  }
+  if (!count)
+    return &empty_plans[mode];
+
+  r_convert_t* plan = calloc(1, sizeof(*plan) + count * sizeof(r_convert_field_t));
+  if (!plan)
+    FATAL_CALLOC("r_convert_plan()");
+  plan->mode = mode;
+  for (char const* const* p = r_dev->fields; *p; ++p) {
+    int conversion = field_conversion(*p, mode);
+    if (conversion < 0)
+      continue;
+    r_convert_field_t* f = &plan->fields[plan->count];
+    f->key = *p;
+    f->new_key = field_new_key(*p, &conversions[conversion]);
+    f->conversion = conversion;
+    if (f->new_key)
+      plan->count++;
+  }
+  if (!plan->count) {
+    free(plan); // r_convert_free() keeps plans without fields
+    return &empty_plans[mode];
+  }
+  return plan;
+}
+
+void r_convert_free(r_convert_t* plan) {
+  if (!plan || plan->count == 0)
+    return;
+  for (unsigned i = 0; i < plan->count; ++i)
+    free(plan->fields[i].new_key);
+  free(plan);
+}
+
+/// Replace every unit in the format, in place if the new unit is not longer.
+static void format_replace(char** format, char const* unit, char const* new_unit) {
+  if (!*format)
+    return;
+  size_t len = strlen(unit);
+  size_t new_len = strlen(new_unit);
+  if (new_len > len) {
+    char* replaced = str_replace(*format, unit, new_unit);
+    free(*format);
+    *format = replaced;
+    return;
+  }
+  for (char* pos = strstr(*format, unit); pos; pos = strstr(pos + new_len, unit)) {
+    memcpy(pos, new_unit, new_len);
+    if (new_len < len)
+      memmove(pos + new_len, pos + len, strlen(pos + len) + 1);
+  }
+}
+
+void r_convert_data(r_device* r_dev, int mode, data_t* data) {
+  r_convert_t* plan = r_dev->convert;
+  if (!plan || plan->mode != mode) {
+    r_convert_free(plan);
+    plan = r_dev->convert = r_convert_plan(r_dev, mode);
+  }
+  if (!plan->count)
+    return;
+
+  for (data_t* d = data; d; d = d->next) {
+    if (d->type != DATA_DOUBLE)
+      continue;
+    r_convert_field_t const* f = plan->fields;
+    r_convert_field_t const* end = plan->fields + plan->count;
+    while (f < end && strcmp(d->key, f->key))
+      ++f;
+    if (f == end)
+      continue;
+
+    unit_conversion_t const* c = &conversions[f->conversion];
+    d->value.v_dbl = c->convert(d->value.v_dbl);
+    size_t new_len = strlen(f->new_key);
+    if (new_len <= strlen(d->key)) {
+      memcpy(d->key, f->new_key, new_len + 1);
+    } else {
+      free(d->key);
+      d->key = strdup(f->new_key);
+    }
+    if (c->unit) {
+      format_replace(&d->format, c->unit, c->new_unit);
+    } else {
+      char* pos;
+      if (d->format && (pos = strrchr(d->format, c->suffix[1])))
+        *pos = c->new_suffix[1];
+    }
+  }
+}
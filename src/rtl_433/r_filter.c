@@ -0,0 +1,212 @@
+/** @file
+    Source-side message filter for rtl_433_ESP.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "r_filter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "data.h"
+#include "fatal.h"
+#include "r_device.h"
+#include "r_private.h"
+#include "rtl_433.h"
+
+static char const* const filter_key_names[FILTER_KEYS] = {
+    "protocol",
+    "model",
+    "id",
+    "channel",
+};
+
+static r_filter_t* get_filter(r_cfg_t* cfg) {
+  if (!cfg->filter) {
+    cfg->filter = calloc(1, sizeof(*cfg->filter));
+    if (!cfg->filter)
+      FATAL_CALLOC("get_filter()");
+    cfg->filter->min_rssi = FILTER_NO_MIN_RSSI;
+  }
+  return cfg->filter;
+}
+
+static int parse_rule(filter_rule_t* rule, char const* spec) {
+  rule->deny = 0;
+  if (*spec == '!') {
+    rule->deny = 1;
+    spec++;
+  }
+  char const* eq = strchr(spec, '=');
+  if (!eq || eq == spec || !eq[1])
+    return -1;
+
+  size_t key_len = eq - spec;
+  for (int k = 0; k < FILTER_KEYS; ++k) {
+    if (strlen(filter_key_names[k]) == key_len &&
+        !strncmp(spec, filter_key_names[k], key_len)) {
+      rule->key = k;
+      rule->str = strdup(eq + 1);
+      if (!rule->str) {
+        WARN_STRDUP("parse_rule()");
+        return -1;
+      }
+      char* end;
+      rule->num = (int)strtol(rule->str, &end, 0);
+      rule->numeric = (*end == '\0');
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int r_filter_add(r_cfg_t* cfg, char const* spec) {
+  r_filter_t* filter = get_filter(cfg);
+  if (filter->num_rules >= FILTER_MAX_RULES)
+    return -1;
+
+  filter_rule_t* rule = &filter->rules[filter->num_rules];
+  if (parse_rule(rule, spec))
+    return -1;
+
+  if (!rule->deny)
+    filter->allow_keys |= 1u << rule->key;
+  filter->num_rules++;
+
+  if (rule->key == FILTER_PROTOCOL)
+    r_filter_update(cfg);
+  return 0;
+}
+
+void r_filter_set_min_rssi(r_cfg_t* cfg, int min_rssi) {
+  get_filter(cfg)->min_rssi = min_rssi;
+}
+
+void r_filter_clear(r_cfg_t* cfg) {
+  r_filter_t* filter = cfg->filter;
+  if (!filter)
+    return;
+  for (unsigned i = 0; i < filter->num_rules; ++i) {
+    free(filter->rules[i].str);
+    filter->rules[i].str = NULL;
+  }
+  filter->num_rules = 0;
+  filter->allow_keys = 0;
+  filter->min_rssi = FILTER_NO_MIN_RSSI;
+  if (filter->skip)
+    memset(filter->skip, 0, filter->num_skip);
+}
+
+void r_filter_free(r_cfg_t* cfg) {
+  r_filter_clear(cfg);
+  if (cfg->filter)
+    free(cfg->filter->skip);
+  free(cfg->filter);
+  cfg->filter = NULL;
+}
+
+static int protocol_matches(filter_rule_t const* rule, r_device const* r_dev) {
+  if (rule->numeric)
+    return rule->num == (int)r_dev->protocol_num;
+  return r_dev->name && !strcmp(rule->str, r_dev->name);
+}
+
+void r_filter_update(r_cfg_t* cfg) {
+  r_filter_t* filter = cfg->filter;
+  if (!filter || !cfg->demod)
+    return;
+
+  list_t* r_devs = &cfg->demod->r_devs;
+  unsigned num_skip = 0;
+  for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+    r_device* r_dev = *iter;
+    if (r_dev->protocol_num >= num_skip)
+      num_skip = r_dev->protocol_num + 1;
+  }
+  if (num_skip > filter->num_skip) {
+    uint8_t* skip = realloc(filter->skip, num_skip);
+    if (!skip) {
+      WARN_REALLOC("r_filter_update()");
+      return;
+    }
+    filter->skip = skip;
+    filter->num_skip = num_skip;
+  }
+  memset(filter->skip, 0, filter->num_skip);
+
+  int allow = filter->allow_keys & (1u << FILTER_PROTOCOL);
+  for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+    r_device* r_dev = *iter;
+    int allowed = !allow;
+    int denied = 0;
+    for (unsigned i = 0; i < filter->num_rules; ++i) {
+      filter_rule_t const* rule = &filter->rules[i];
+      if (rule->key != FILTER_PROTOCOL || !protocol_matches(rule, r_dev))
+        continue;
+      if (rule->deny)
+        denied = 1;
+      else
+        allowed = 1;
+    }
+    filter->skip[r_dev->protocol_num] = denied || !allowed;
+  }
+}
+
+int r_filter_signal(r_cfg_t* cfg, int rssi) {
+  r_filter_t* filter = cfg->filter;
+  if (!filter || filter->min_rssi == FILTER_NO_MIN_RSSI || rssi >= filter->min_rssi)
+    return 1;
+  filter->signals_filtered++;
+  return 0;
+}
+
+static int value_matches(filter_rule_t const* rule, data_t const* d) {
+  if (d->type == DATA_INT)
+    return rule->numeric && rule->num == d->value.v_int;
+  if (d->type == DATA_STRING)
+    return !strcmp(rule->str, (char const*)d->value.v_ptr);
+  return 0;
+}
+
+int r_filter_data(r_cfg_t* cfg, data_t* data) {
+  r_filter_t* filter = cfg->filter;
+  if (!filter || !filter->num_rules)
+    return 1;
+
+  // look up each filtered key once
+  data_t const* fields[FILTER_KEYS] = {NULL};
+  for (data_t const* d = data; d; d = d->next) {
+    for (int k = FILTER_MODEL; k < FILTER_KEYS; ++k) {
+      if (!fields[k] && !strcmp(d->key, filter_key_names[k])) {
+        fields[k] = d;
+        break;
+      }
+    }
+  }
+
+  unsigned allowed = 0;
+  for (unsigned i = 0; i < filter->num_rules; ++i) {
+    filter_rule_t const* rule = &filter->rules[i];
+    if (rule->key == FILTER_PROTOCOL || !fields[rule->key])
+      continue;
+    if (!value_matches(rule, fields[rule->key]))
+      continue;
+    if (rule->deny) {
+      filter->messages_filtered++;
+      return 0;
+    }
+    allowed |= 1u << rule->key;
+  }
+
+  // every key with allow rules needs a match, protocol rules were applied already
+  unsigned required = filter->allow_keys & ~(1u << FILTER_PROTOCOL);
+  if ((allowed & required) != required) {
+    filter->messages_filtered++;
+    return 0;
+  }
+  return 1;
+}
@@ -0,0 +1,131 @@
+/** @file
+    Fingerprint cache of recently decoded pulse trains.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "r_fingerprint.h"
+
+#include <stdlib.h>
+
+#include "list.h"
+#include "pulse_classes.h"
+#include "r_api.h"
+#include "r_device.h"
+#include "r_filter.h"
+#include "rtl_433.h"
+
+static uint32_t fnv1a(uint32_t hash, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    hash ^= (value >> (8 * i)) & 0xff;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/// Quantize a width to about 12% steps, log2 with 3 fraction bits.
+static uint32_t fp_quantize(int width) {
+  if (width <= 0)
+    return 0;
+  uint32_t w = width;
+  int msb = 31 - __builtin_clz(w);
+  uint32_t frac = msb >= 3 ? (w >> (msb - 3)) & 0x7 : (w << (3 - msb)) & 0x7;
+  return (msb << 3) | frac;
+}
+
+uint32_t fp_fingerprint(pulse_data_t const* pulses) {
+  pulse_classes_t const* classes = pulse_classes_get(pulses);
+  if (!classes || !classes->num_pulses)
+    return 0;
+
+  uint32_t hash = 2166136261u;
+  hash = fnv1a(hash, classes->num_pulses);
+  for (unsigned c = 0; c < classes->pulse_count; ++c)
+    hash = fnv1a(hash, fp_quantize(classes->pulse[c].mean));
+  for (unsigned c = 0; c < classes->gap_count; ++c) {
+    // a class of its own is usually the trailing gap, which varies
+    if (classes->gap[c].count > 1)
+      hash = fnv1a(hash, fp_quantize(classes->gap[c].mean));
+  }
+  // the trailing gap is not part of the frame
+  for (unsigned n = 0; n < classes->num_pulses; ++n) {
+    uint32_t gap = n + 1 < classes->num_pulses ? classes->gap_class[n] : 0xff;
+    hash = fnv1a(hash, classes->pulse_class[n] | gap << 8);
+  }
+  return hash ? hash : 1;
+}
+
+static fp_entry_t* fp_cache_find(fp_cache_t* cache, uint32_t fingerprint) {
+  for (unsigned i = 0; i < FP_CACHE_SIZE; ++i) {
+    if (cache->entries[i].fingerprint == fingerprint)
+      return &cache->entries[i];
+  }
+  return NULL;
+}
+
+/// Remember the decoders whose decode_ok went up during the full run.
+static void fp_cache_store(fp_cache_t* cache, uint32_t fingerprint, list_t* r_devs) {
+  fp_entry_t* e = &cache->entries[0];
+  for (unsigned i = 1; i < FP_CACHE_SIZE && e->fingerprint; ++i) {
+    if (!cache->entries[i].fingerprint || cache->entries[i].last_used < e->last_used)
+      e = &cache->entries[i];
+  }
+  e->fingerprint = fingerprint;
+  e->last_used = ++cache->clock;
+  e->num_decoders = 0;
+  for (unsigned i = 0; i < r_devs->len && i < cache->num_decode_ok; ++i) {
+    r_device* r_dev = r_devs->elems[i];
+    if (r_dev->decode_ok != cache->decode_ok[i] && e->num_decoders < FP_CACHE_DECODERS)
+      e->decoders[e->num_decoders++] = r_dev;
+  }
+  if (!e->num_decoders)
+    e->fingerprint = 0;
+}
+
+static int fp_cache_full(list_t* r_devs, pulse_data_t* pulses, int fsk) {
+  return fsk ? run_fsk_demods(r_devs, pulses) : run_ook_demods(r_devs, pulses);
+}
+
+int fp_cache_demod(fp_cache_t* cache, list_t* r_devs, pulse_data_t* pulses, int fsk) {
+  uint32_t fingerprint = fp_fingerprint(pulses);
+  if (!fingerprint || !r_devs->len)
+    return fp_cache_full(r_devs, pulses, fsk);
+
+  fp_entry_t* e = fp_cache_find(cache, fingerprint);
+  if (e) {
+    int events = 0;
+    for (unsigned i = 0; i < e->num_decoders; ++i) {
+      r_device* r_dev = e->decoders[i];
+      if (r_dev->schedule_tried || !r_filter_decoder(((r_cfg_t*)r_dev->output_ctx)->filter, r_dev->protocol_num))
+        continue;
+      events += fsk ? run_fsk_demod(r_dev, pulses) : run_ook_demod(r_dev, pulses);
+    }
+    if (events > 0) {
+      cache->hits++;
+      e->last_used = ++cache->clock;
+      return events;
+    }
+    cache->stale++;
+    e->fingerprint = 0;
+  } else {
+    cache->misses++;
+  }
+
+  if (cache->num_decode_ok < r_devs->len) {
+    unsigned* decode_ok = realloc(cache->decode_ok, r_devs->len * sizeof(*decode_ok));
+    if (!decode_ok)
+      return fp_cache_full(r_devs, pulses, fsk);
+    cache->decode_ok = decode_ok;
+    cache->num_decode_ok = r_devs->len;
+  }
+  for (unsigned i = 0; i < r_devs->len; ++i)
+    cache->decode_ok[i] = ((r_device*)r_devs->elems[i])->decode_ok;
+
+  int events = fp_cache_full(r_devs, pulses, fsk);
+  if (events > 0)
+    fp_cache_store(cache, fingerprint, r_devs);
+  return events;
+}
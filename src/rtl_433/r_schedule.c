@@ -0,0 +1,199 @@
+/** @file
+    Transmission schedule learner of known devices.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "r_schedule.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "data.h"
+#include "pulse_data.h"
+#include "r_api.h"
+#include "r_device.h"
+#include "r_filter.h"
+#include "rtl_433.h"
+
+static uint32_t abs_diff(uint32_t a, uint32_t b) {
+  return a > b ? a - b : b - a;
+}
+
+static uint32_t sched_tolerance(uint32_t period, unsigned k) {
+  return SCHEDULE_JITTER_MS + k * (period / 32);
+}
+
+/// Number of periods in an interval, 0 if it is not a multiple of the period.
+static unsigned sched_periods(uint32_t interval, uint32_t period) {
+  if (!period)
+    return 0;
+  unsigned k = (interval + period / 2) / period;
+  if (k < 1 || k > SCHEDULE_MAX_GAP || abs_diff(interval, k * period) > sched_tolerance(period, k))
+    return 0;
+  return k;
+}
+
+/// The device transmits now, the window grows with k and is only narrow
+/// enough to predict for the next few transmissions.
+static int sched_due(sched_entry_t const* e, uint32_t now) {
+  uint32_t elapsed = now - e->last;
+  if (elapsed < SCHEDULE_BURST_MS)
+    return 1;
+  unsigned k = sched_periods(elapsed, e->period);
+  return k && k <= SCHEDULE_PREDICT;
+}
+
+int r_schedule_demod(r_schedule_t* schedule, pulse_data_t* pulses, int fsk, uint32_t now) {
+  schedule->now = now;
+
+  r_device** run = schedule->tried;
+  unsigned num_run = 0;
+  int events = 0;
+  for (unsigned i = 0; i < SCHEDULE_SIZE; ++i) {
+    sched_entry_t const* e = &schedule->entries[i];
+    if (!e->decoder || !sched_due(e, now))
+      continue;
+    if ((e->decoder->modulation >= FSK_DEMOD_MIN_VAL) != (fsk != 0))
+      continue;
+    // devices of the same protocol need one run
+    unsigned j = 0;
+    while (j < num_run && run[j] != e->decoder)
+      ++j;
+    if (j < num_run)
+      continue;
+    r_device* r_dev = run[num_run++] = e->decoder;
+    r_dev->schedule_tried = 1;
+    if (!r_filter_decoder(((r_cfg_t*)r_dev->output_ctx)->filter, r_dev->protocol_num))
+      continue;
+    events += fsk ? run_fsk_demod(r_dev, pulses) : run_ook_demod(r_dev, pulses);
+  }
+  schedule->num_tried = num_run;
+  if (!num_run)
+    return 0;
+  if (events > 0)
+    schedule->hits++;
+  else
+    schedule->misses++;
+  return events;
+}
+
+void r_schedule_end(r_schedule_t* schedule) {
+  for (unsigned i = 0; i < schedule->num_tried; ++i)
+    schedule->tried[i]->schedule_tried = 0;
+  schedule->num_tried = 0;
+}
+
+/// The id of a message as text, 0 if it has none.
+static int sched_id(data_t const* data, char* id) {
+  for (data_t const* d = data; d; d = d->next) {
+    if (strcmp(d->key, "id"))
+      continue;
+    if (d->type == DATA_INT)
+      snprintf(id, SCHEDULE_ID_LEN, "%d", d->value.v_int);
+    else if (d->type == DATA_STRING)
+      snprintf(id, SCHEDULE_ID_LEN, "%s", (char const*)d->value.v_ptr);
+    else
+      return 0;
+    return 1;
+  }
+  return 0;
+}
+
+static sched_entry_t* sched_entry(r_schedule_t* schedule, r_device* decoder, char const* id) {
+  sched_entry_t* oldest = &schedule->entries[0];
+  for (unsigned i = 0; i < SCHEDULE_SIZE; ++i) {
+    sched_entry_t* e = &schedule->entries[i];
+    if (e->decoder == decoder && !strcmp(e->id, id))
+      return e;
+    if (oldest->decoder && (!e->decoder || schedule->now - e->last > schedule->now - oldest->last))
+      oldest = e;
+  }
+  // replace the device heard least recently
+  memset(oldest, 0, sizeof(*oldest));
+  oldest->decoder = decoder;
+  snprintf(oldest->id, sizeof(oldest->id), "%s", id);
+  oldest->last = schedule->now;
+  oldest->received = 1;
+  return NULL;
+}
+
+static void sched_learn(sched_entry_t* e, uint32_t interval) {
+  if (e->period) {
+    unsigned k = sched_periods(interval, e->period);
+    if (k) {
+      e->missed += k - 1;
+      // follow the drift of the transmitter clock
+      e->period += ((int32_t)(interval / k) - (int32_t)e->period) / 8;
+      e->mismatches = 0;
+    } else if (interval > SCHEDULE_MAX_GAP * e->period || ++e->mismatches >= 3) {
+      e->period = 0;
+      e->interval = interval;
+      e->mismatches = 0;
+    }
+    return;
+  }
+  // learning, two intervals agree, one may span missed transmissions
+  uint32_t lo = interval < e->interval ? interval : e->interval;
+  uint32_t hi = interval < e->interval ? e->interval : interval;
+  unsigned k = lo ? (hi + lo / 2) / lo : 0;
+  if (k >= 1 && k <= 4 && abs_diff(hi, k * lo) <= sched_tolerance(lo, k))
+    e->period = lo;
+  else
+    e->interval = interval;
+}
+
+void r_schedule_message(r_schedule_t* schedule, r_device* decoder, data_t* data) {
+  char id[SCHEDULE_ID_LEN];
+  if (!sched_id(data, id))
+    return;
+  sched_entry_t* e = sched_entry(schedule, decoder, id);
+  if (!e)
+    return; // a new device
+  uint32_t interval = schedule->now - e->last;
+  if (interval < SCHEDULE_BURST_MS)
+    return; // a repeat within the burst
+  e->received++;
+  sched_learn(e, interval);
+  e->last = schedule->now;
+}
+
+unsigned r_schedule_missed(sched_entry_t const* e, uint32_t now) {
+  uint32_t elapsed = now - e->last;
+  if (!e->period || elapsed <= e->period + sched_tolerance(e->period, 1))
+    return e->missed;
+  unsigned overdue = (elapsed - sched_tolerance(e->period, 1)) / e->period;
+  return e->missed + (overdue < SCHEDULE_MAX_GAP ? overdue : SCHEDULE_MAX_GAP);
+}
+
+unsigned r_schedule_learned(r_schedule_t const* schedule) {
+  unsigned learned = 0;
+  for (unsigned i = 0; i < SCHEDULE_SIZE; ++i) {
+    if (schedule->entries[i].decoder && schedule->entries[i].period)
+      learned++;
+  }
+  return learned;
+}
+
+data_t* r_schedule_data(r_schedule_t const* schedule, unsigned index, uint32_t now) {
+  if (index >= SCHEDULE_SIZE || !schedule->entries[index].decoder)
+    return NULL;
+  sched_entry_t const* e = &schedule->entries[index];
+  unsigned missed = r_schedule_missed(e, now);
+  unsigned expected = e->received + missed;
+  /* clang-format off */
+  return data_make(
+          "model",    "", DATA_STRING, "schedule",
+          "protocol", "", DATA_STRING, e->decoder->name,
+          "id",       "", DATA_STRING, e->id,
+          "period",   "", DATA_COND, e->period, DATA_DOUBLE, e->period / 1000.0,
+          "received", "", DATA_INT, e->received,
+          "missed",   "", DATA_COND, e->period, DATA_INT, missed,
+          "loss",     "", DATA_COND, e->period, DATA_DOUBLE, expected ? 100.0 * missed / expected : 0.0,
+          "lastSeen", "", DATA_INT, (int)((now - e->last) / 1000),
+          NULL);
+  /* clang-format on */
+}
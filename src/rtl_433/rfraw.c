@@ -0,0 +1,365 @@
+/** @file
+    RfRaw format functions.
+
+    RfRaw is the bucket format of the Portisch firmware of the Sonoff RF
+    Bridge, also read by rtl_433 ("rfraw:" input) and https://triq.org/pdv.
+    A segment is "AA B0 len buckets repeats bucket-words... data... 55" or
+    "AA B1 buckets bucket-words... data... 55", the bucket words are widths
+    in us.  Every data nibble is a bucket index, with bit 3 set for a pulse
+    and clear for a gap.  Segments may be separated by '+' or spaces.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "rfraw.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RFRAW_BUCKETS 8
+#define RFRAW_TOLERANCE 0.2
+#define RFRAW_MAX_PACKET (255 - 3 - 2 * RFRAW_BUCKETS) ///< pulses per segment, the segment length is a byte
+
+static int hex_nibble(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+static char const* skip_separators(char const* p) {
+  while (*p == ' ' || *p == '\t' || *p == '+' || *p == '-' || *p == '\r' || *p == '\n')
+    ++p;
+  return p;
+}
+
+static char const* skip_prefix(char const* p) {
+  p = skip_separators(p);
+  if (!strncmp(p, "rfraw:", 6))
+    p = skip_separators(p + 6);
+  return p;
+}
+
+/// Next nibble, spaces within a segment are skipped, -1 at the end.
+static int get_nibble(char const** p) {
+  while (**p == ' ' || **p == '\t')
+    ++*p;
+  int n = hex_nibble(**p);
+  if (n >= 0)
+    ++*p;
+  return n;
+}
+
+static int get_byte(char const** p) {
+  int hi = get_nibble(p);
+  int lo = hi < 0 ? -1 : get_nibble(p);
+  return lo < 0 ? -1 : hi << 4 | lo;
+}
+
+static int peek_byte(char const* p) {
+  return get_byte(&p);
+}
+
+bool rfraw_check(char const* p) {
+  p = skip_prefix(p);
+  if (get_byte(&p) != 0xaa)
+    return false;
+  int fmt = get_byte(&p);
+  return fmt == 0xb0 || fmt == 0xb1;
+}
+
+static void append_width(pulse_data_t* data, int pulse, int width, bool* pulse_needed) {
+  if (data->num_pulses >= PD_MAX_PULSES)
+    return;
+  if (pulse) {
+    if (!*pulse_needed) {
+      data->pulse[data->num_pulses] += width; // two pulses in a row
+      return;
+    }
+    data->pulse[data->num_pulses] = width;
+    data->gap[data->num_pulses] = 0;
+    *pulse_needed = false;
+  } else {
+    if (*pulse_needed && data->num_pulses > 0) {
+      data->gap[data->num_pulses - 1] += width; // two gaps in a row
+      return;
+    }
+    if (*pulse_needed)
+      data->pulse[data->num_pulses] = 0; // leading gap
+    data->gap[data->num_pulses++] = width;
+    *pulse_needed = true;
+  }
+}
+
+static bool parse_segment(pulse_data_t* data, char const** p, float to_samples) {
+  if (get_byte(p) != 0xaa)
+    return false;
+  int fmt = get_byte(p);
+  if (fmt != 0xb0 && fmt != 0xb1)
+    return false;
+  if (fmt == 0xb0)
+    get_byte(p); // length
+  int buckets = get_byte(p);
+  if (buckets < 1 || buckets > RFRAW_BUCKETS)
+    return false;
+  int repeats = fmt == 0xb0 ? get_byte(p) : 1;
+  if (repeats < 1)
+    repeats = 1;
+  int widths[RFRAW_BUCKETS];
+  for (int i = 0; i < buckets; ++i) {
+    int hi = get_byte(p);
+    int lo = get_byte(p);
+    if (hi < 0 || lo < 0)
+      return false;
+    widths[i] = (hi << 8 | lo) * to_samples;
+  }
+
+  unsigned start = data->num_pulses;
+  bool pulse_needed = true;
+  for (unsigned nibbles = 0;; ++nibbles) {
+    if (!(nibbles & 1) && peek_byte(*p) == 0x55) {
+      get_byte(p);
+      break;
+    }
+    int n = get_nibble(p);
+    if (n < 0)
+      return false; // unterminated
+    if ((n & 7) >= buckets)
+      return false;
+    append_width(data, n & 8, widths[n & 7], &pulse_needed);
+  }
+  if (!pulse_needed && data->num_pulses < PD_MAX_PULSES)
+    data->num_pulses++; // a trailing pulse without gap
+
+  // B0 repeats the packet
+  unsigned len = data->num_pulses - start;
+  for (int r = 1; r < repeats && data->num_pulses + len <= PD_MAX_PULSES; ++r) {
+    memcpy(&data->pulse[data->num_pulses], &data->pulse[start], len * sizeof(*data->pulse));
+    memcpy(&data->gap[data->num_pulses], &data->gap[start], len * sizeof(*data->gap));
+    data->num_pulses += len;
+  }
+  return true;
+}
+
+bool rfraw_parse(pulse_data_t* data, char const* p) {
+  if (!p || !*p)
+    return false;
+  if (!data->sample_rate)
+    data->sample_rate = 1000000;
+  float to_samples = data->sample_rate / 1e6f;
+
+  // pulses are appended, the data is not cleared
+  unsigned start = data->num_pulses;
+  p = skip_prefix(p);
+  while (*p && parse_segment(data, &p, to_samples))
+    p = skip_separators(p);
+  return data->num_pulses > start;
+}
+
+/// Width buckets of a train, means in us.
+typedef struct rfraw_buckets {
+  unsigned count;
+  double sum[RFRAW_BUCKETS];
+  unsigned members[RFRAW_BUCKETS];
+  int mean[RFRAW_BUCKETS];
+} rfraw_buckets_t;
+
+static int bucket_find(rfraw_buckets_t const* b, int width) {
+  int best = -1;
+  int best_diff = 0;
+  for (unsigned i = 0; i < b->count; ++i) {
+    int diff = abs(width - b->mean[i]);
+    if (best < 0 || diff < best_diff) {
+      best = i;
+      best_diff = diff;
+    }
+  }
+  return best;
+}
+
+static void bucket_remove(rfraw_buckets_t* b, unsigned i) {
+  b->count--;
+  for (; i < b->count; ++i) {
+    b->sum[i] = b->sum[i + 1];
+    b->members[i] = b->members[i + 1];
+    b->mean[i] = b->mean[i + 1];
+  }
+}
+
+/// Merge the two buckets closest by ratio.
+static void bucket_merge_closest(rfraw_buckets_t* b) {
+  unsigned lo = 0;
+  double best = 0;
+  for (unsigned i = 0; i + 1 < b->count; ++i) {
+    double ratio = (b->mean[i + 1] + 1.0) / (b->mean[i] + 1.0);
+    if (i == 0 || ratio < best) {
+      lo = i;
+      best = ratio;
+    }
+  }
+  b->sum[lo] += b->sum[lo + 1];
+  b->members[lo] += b->members[lo + 1];
+  b->mean[lo] = b->sum[lo] / b->members[lo];
+  bucket_remove(b, lo + 1);
+}
+
+static void bucket_add(rfraw_buckets_t* b, int width) {
+  int i = bucket_find(b, width);
+  if (i >= 0 && (width == b->mean[i] || abs(width - b->mean[i]) <= b->mean[i] * RFRAW_TOLERANCE)) {
+    b->sum[i] += width;
+    b->members[i]++;
+    b->mean[i] = b->sum[i] / b->members[i];
+    return;
+  }
+  if (b->count == RFRAW_BUCKETS)
+    bucket_merge_closest(b);
+  // keep the buckets sorted
+  unsigned pos = b->count;
+  while (pos > 0 && b->mean[pos - 1] > width) {
+    b->sum[pos] = b->sum[pos - 1];
+    b->members[pos] = b->members[pos - 1];
+    b->mean[pos] = b->mean[pos - 1];
+    pos--;
+  }
+  b->sum[pos] = width;
+  b->members[pos] = 1;
+  b->mean[pos] = width;
+  b->count++;
+}
+
+/// Output with snprintf() semantics, the length counts what did not fit.
+typedef struct rfraw_out {
+  char* buf;
+  size_t size;
+  size_t len;
+} rfraw_out_t;
+
+static void out_char(rfraw_out_t* out, char c) {
+  if (out->len + 1 < out->size)
+    out->buf[out->len] = c;
+  out->len++;
+}
+
+static void out_byte(rfraw_out_t* out, unsigned byte) {
+  static char const hex[] = "0123456789ABCDEF";
+  out_char(out, hex[byte >> 4 & 0xf]);
+  out_char(out, hex[byte & 0xf]);
+}
+
+/// A width in us as the 16 bit bucket words can hold it.
+static int width_us(int width, double to_us) {
+  double us = width * to_us;
+  return us < 0 ? 0 : us > 0xffff ? 0xffff : (int)(us + 0.5);
+}
+
+static unsigned data_byte(rfraw_buckets_t const* b, pulse_data_t const* data, unsigned i, double to_us) {
+  return 0x80 | bucket_find(b, width_us(data->pulse[i], to_us)) << 4 | bucket_find(b, width_us(data->gap[i], to_us));
+}
+
+static bool packet_equal(rfraw_buckets_t const* b, pulse_data_t const* data, unsigned a, unsigned c, unsigned len, double to_us) {
+  for (unsigned i = 0; i < len; ++i) {
+    if (data_byte(b, data, a + i, to_us) != data_byte(b, data, c + i, to_us))
+      return false;
+  }
+  return true;
+}
+
+/// End of the packet starting at start, after a gap of the longest bucket.
+static unsigned packet_end(rfraw_buckets_t const* b, pulse_data_t const* data, unsigned start, double to_us) {
+  unsigned end = start;
+  while (end < data->num_pulses && end - start < RFRAW_MAX_PACKET) {
+    int g = bucket_find(b, width_us(data->gap[end++], to_us));
+    if (b->count > 2 && g == (int)b->count - 1)
+      break;
+  }
+  return end;
+}
+
+int rfraw_encode(pulse_data_t const* data, char* buf, size_t size) {
+  rfraw_out_t out = {buf, size, 0};
+  if (size)
+    *buf = '\0';
+  if (!data->num_pulses)
+    return 0;
+  double to_us = data->sample_rate ? 1e6 / data->sample_rate : 1.0;
+
+  rfraw_buckets_t b = {0};
+  for (unsigned i = 0; i < data->num_pulses; ++i) {
+    bucket_add(&b, width_us(data->pulse[i], to_us));
+    bucket_add(&b, width_us(data->gap[i], to_us));
+  }
+
+  unsigned start = 0;
+  while (start < data->num_pulses) {
+    unsigned end = packet_end(&b, data, start, to_us);
+    unsigned len = end - start;
+    // fold identical packets into repeats
+    unsigned repeats = 1;
+    while (repeats < 255 && end + len <= data->num_pulses && packet_end(&b, data, end, to_us) == end + len
+            && packet_equal(&b, data, start, end, len, to_us)) {
+      end += len;
+      repeats++;
+    }
+
+    if (start > 0)
+      out_char(&out, '+');
+    out_byte(&out, 0xaa);
+    out_byte(&out, 0xb0);
+    unsigned seg_len = 3 + 2 * b.count + len; // buckets, repeats, words, data and 0x55
+    out_byte(&out, seg_len); // fits, see RFRAW_MAX_PACKET
+    out_byte(&out, b.count);
+    out_byte(&out, repeats);
+    for (unsigned i = 0; i < b.count; ++i) {
+      out_byte(&out, b.mean[i] >> 8);
+      out_byte(&out, b.mean[i] & 0xff);
+    }
+    for (unsigned i = start; i < start + len; ++i)
+      out_byte(&out, data_byte(&b, data, i, to_us));
+    out_byte(&out, 0x55);
+    start = end;
+  }
+  if (size)
+    buf[out.len < size ? out.len : size - 1] = '\0';
+  return out.len;
+}
+
+bool pulse_str_parse(pulse_data_t* data, char const* p) {
+  if (!p)
+    return false;
+  if (!data->sample_rate)
+    data->sample_rate = 1000000;
+  float to_samples = data->sample_rate / 1e6f;
+
+  // pulses are appended, the data is not cleared
+  unsigned start = data->num_pulses;
+  bool pulse_needed = true;
+  while (*p && data->num_pulses < PD_MAX_PULSES) {
+    if (*p == '+' || *p == '-') {
+      char* end;
+      long width = strtol(p + 1, &end, 10);
+      if (end == p + 1 || width < 0)
+        break;
+      append_width(data, *p == '+', width * to_samples, &pulse_needed);
+      p = end;
+    } else if (*p == '(') {
+      // per pulse RSSI of SIGNAL_RSSI
+      p = strchr(p, ')');
+      if (!p)
+        break;
+      ++p;
+    } else if (*p == ' ' || *p == '\t') {
+      ++p;
+    } else {
+      break;
+    }
+  }
+  if (!pulse_needed && data->num_pulses < PD_MAX_PULSES)
+    data->num_pulses++; // a trailing pulse without gap
+  return data->num_pulses > start;
+}
@@ -0,0 +1,67 @@
+/** @file
+    Ring of timed RSSI samples for the RSSI of each pulse.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "rssi_ring.h"
+
+#include "pulse_data.h"
+
+void rssi_ring_push(rssi_ring_t* ring, uint32_t time_us, int rssi, int high) {
+  unsigned i = ring->head++ % RSSI_RING_SIZE;
+  ring->time[i] = time_us;
+  ring->rssi[i] = rssi;
+  ring->high[i] = high != 0;
+}
+
+void rssi_ring_apply(rssi_ring_t const* ring, pulse_data_t* pulses, unsigned num_pulses, uint32_t start_us) {
+#ifdef SIGNAL_RSSI
+  unsigned count = ring->head < RSSI_RING_SIZE ? ring->head : RSSI_RING_SIZE;
+  // samples oldest first, times relative to the train start as they may wrap
+  unsigned first = ring->head - count;
+  unsigned s = 0;
+  int32_t t = 0;
+  for (unsigned i = 0; i < num_pulses && i < PD_MAX_PULSES; ++i) {
+    int32_t end = t + pulses->pulse[i];
+    int32_t mid = t + pulses->pulse[i] / 2;
+    // first sample of the pulse
+    while (s < count && (int32_t)(ring->time[(first + s) % RSSI_RING_SIZE] - start_us) < t)
+      s++;
+    // the samples with the pin high closest before and after the middle
+    int a = -1;
+    int b = -1;
+    for (unsigned j = s; j < count; ++j) {
+      unsigned k = (first + j) % RSSI_RING_SIZE;
+      int32_t tj = ring->time[k] - start_us;
+      if (tj > end)
+        break;
+      if (!ring->high[k])
+        continue;
+      if (tj <= mid)
+        a = k;
+      else if (b < 0)
+        b = k;
+    }
+    t = end + pulses->gap[i];
+
+    if (a < 0 && b < 0) {
+      pulses->rssi[i] = RSSI_RING_NONE;
+    } else if (a < 0 || b < 0) {
+      pulses->rssi[i] = ring->rssi[a < 0 ? b : a];
+    } else {
+      int32_t ta = ring->time[a] - start_us;
+      int32_t tb = ring->time[b] - start_us;
+      pulses->rssi[i] = ring->rssi[a] + (int32_t)(ring->rssi[b] - ring->rssi[a]) * (mid - ta) / (tb - ta);
+    }
+  }
+#else
+  (void)ring;
+  (void)pulses;
+  (void)num_pulses;
+  (void)start_us;
+#endif
+}
@@ -0,0 +1,30 @@
+/** @file
+    Stack painting to measure the stack depth of the decoders.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "stack_profile.h"
+
+#include <string.h>
+
+void stack_profile_paint(uint8_t* lo, uint8_t* hi) {
+  if (hi > lo)
+    memset(lo, STACK_PROFILE_FILL, hi - lo);
+}
+
+unsigned stack_profile_depth(uint8_t const* lo, uint8_t const* hi) {
+  // the stack grows down, the lowest changed byte is the deepest use
+  uint8_t const* p = lo;
+  while (p < hi && *p == STACK_PROFILE_FILL)
+    ++p;
+  return hi - p;
+}
+
+unsigned stack_profile_recommend(unsigned base, unsigned depth, float scale, unsigned reserve) {
+  unsigned size = base + (unsigned)(depth * scale + 0.5f) + reserve;
+  return (size + STACK_PROFILE_ALIGN - 1) / STACK_PROFILE_ALIGN * STACK_PROFILE_ALIGN;
+}
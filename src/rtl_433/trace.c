@@ -0,0 +1,102 @@
+/** @file
+    Binary event trace ring for the capture and decode pipeline.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include "trace.h"
+
+#ifdef RTL_TRACE
+
+#  include <string.h>
+
+#  ifdef ESP_PLATFORM
+#    include "esp_attr.h"
+#    include "esp_timer.h"
+#    include "freertos/FreeRTOS.h"
+#    include "freertos/task.h"
+#    define TRACE_ATTR IRAM_ATTR
+#  else
+#    include <time.h>
+#    define TRACE_ATTR
+#  endif
+
+#  if RTL_TRACE_SIZE & (RTL_TRACE_SIZE - 1)
+#    error "RTL_TRACE_SIZE must be a power of 2"
+#  endif
+
+typedef struct trace_record {
+  uint32_t time;
+  uint8_t event;
+  uint8_t core;
+  uint16_t arg;
+} trace_record_t;
+
+static trace_record_t trace_ring[RTL_TRACE_SIZE];
+static uint32_t trace_head; ///< records written, the next slot
+static volatile int trace_paused;
+
+static inline uint32_t trace_time(void) {
+#  ifdef ESP_PLATFORM
+  return esp_timer_get_time();
+#  else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+#  endif
+}
+
+static inline uint8_t trace_core(void) {
+#  ifdef ESP_PLATFORM
+  return xPortGetCoreID() | (xPortInIsrContext() ? TRACE_CORE_ISR : 0);
+#  else
+  return 0;
+#  endif
+}
+
+void TRACE_ATTR trace_event(unsigned event, unsigned arg) {
+  if (trace_paused)
+    return;
+  uint32_t slot = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED) & (RTL_TRACE_SIZE - 1);
+  trace_record_t* r = &trace_ring[slot];
+  r->time = trace_time();
+  r->event = event;
+  r->core = trace_core();
+  r->arg = arg;
+}
+
+static void put_le32(uint8_t* buf, uint32_t v) {
+  buf[0] = v;
+  buf[1] = v >> 8;
+  buf[2] = v >> 16;
+  buf[3] = v >> 24;
+}
+
+void trace_dump(trace_write_fn write, void* ctx) {
+  trace_paused = 1;
+  uint32_t head = __atomic_load_n(&trace_head, __ATOMIC_RELAXED);
+  uint32_t count = head < RTL_TRACE_SIZE ? head : RTL_TRACE_SIZE;
+
+  uint8_t header[TRACE_HEADER_LEN] = {'R', 'T', 'R', 'C', TRACE_VERSION, TRACE_RECORD_LEN, 0, 0};
+  put_le32(header + 8, count);
+  write(header, sizeof(header), ctx);
+  for (uint32_t n = head - count; n != head; ++n) {
+    trace_record_t const* r = &trace_ring[n & (RTL_TRACE_SIZE - 1)];
+    uint8_t rec[TRACE_RECORD_LEN];
+    put_le32(rec, r->time);
+    rec[4] = r->event;
+    rec[5] = r->core;
+    rec[6] = r->arg;
+    rec[7] = r->arg >> 8;
+    write(rec, sizeof(rec), ctx);
+  }
+
+  memset(trace_ring, 0, sizeof(trace_ring));
+  __atomic_store_n(&trace_head, 0, __ATOMIC_RELAXED);
+  trace_paused = 0;
+}
+
+#endif /* RTL_TRACE */
@@ -26,6 +26,11 @@
 
 #include "receiver.h"
 #include "signalDecoder.h"
+#include "soc/gpio_reg.h"
+
+#ifdef AUTOTUNE
+#  include <Preferences.h>
+#endif
 
 /*----------------------------- Transceiver SPI Connections -----------------------------*/
 
@@ -68,7 +73,27 @@ Module* _mod = radio.getMod();
 /**
  * Is the receiver currently receiving a signal
  */
-static bool receiveMode = false;
+static volatile bool receiveMode = false;
+
+/**
+ * Cycle count of the previous accepted edge, the cycle counter is per core
+ * so it is only compared within interruptHandler
+ */
+static uint32_t _lastEdgeCycles = 0;
+
+/**
+ * Set when _lastChange was set by the receiver task, the next edge is timed
+ * against _lastChange instead of _lastEdgeCycles
+ */
+static volatile bool _edgeResync = true;
+
+/**
+ * Direct input register and mask of the receiver gpio, and cycles per micro
+ * second, set up in enableReceiver
+ */
+static volatile uint32_t* receiverInReg = (volatile uint32_t*)GPIO_IN_REG;
+static uint32_t receiverInMask = 0;
+static uint32_t cyclesPerMicro = 1;
 
 /**
  * Timestamp in micros for start of current signal
@@ -86,26 +111,110 @@ static unsigned long gapStart = micros();
  */
 static unsigned long signalEnd = micros();
 
+#ifdef AUTOTUNE
+/**
+ * Held by the receiver task while it reads the transceiver, autotune changes
+ * the settings over the same SPI bus from the caller task
+ */
+static SemaphoreHandle_t radioMutex = NULL;
+#endif
+
+#ifdef STREAMING_DECODE
+/**
+ * Gap in micros that ends a packet, the largest reset_limit below the
+ * gap that ends the signal, set up in initReceiver.  Pulses before a longer
+ * gap are handed to the decoder while the signal is still being received
+ */
+static unsigned int splitGap = 0;
+
+/**
+ * Timestamp in micros for start of the current train, the signal start or
+ * the end of the previous streamed train
+ */
+static volatile unsigned long trainStart = micros();
+
+/**
+ * Trains handed to the decoder before the end of their signal
+ */
+static volatile uint32_t streamedTrains = 0;
+#endif
+
+#ifdef PROTOCOL_HANGOVER
+/**
+ * Time in micros the signal and its edges may stop before the signal is
+ * complete, the largest reset_limit of the enabled decoders up to
+ * MINIMUM_SIGNAL_LENGTH.  Only shorter when the filters leave decoders with
+ * short reset limits, the default set includes 80 ms ones
+ */
+static unsigned int hangover = MINIMUM_SIGNAL_LENGTH;
+
+/**
+ * Shortest signal in micros passed to the decoder, the shortest train any
+ * enabled decoder accepts
+ */
+static unsigned int minSignalLength = MINIMUM_SIGNAL_LENGTH;
+
+/**
+ * Timestamp in micros of the most recent completed pulse of the current signal
+ */
+static unsigned long lastEdge = micros();
+#endif
+
+#ifdef SIGNAL_RSSI
+/**
+ * RSSI samples of the receiver task with their time, for the level of each pulse
+ */
+static rssi_ring_t rssiRing;
+
+/**
+ * The interrupt handler wrapped the current train at PD_MAX_PULSES, its
+ * pulses no longer follow each other from the train start
+ */
+static volatile bool trainWrapped = false;
+
+#  ifdef STREAMING_DECODE
+/**
+ * Trains split off by the interrupt handler, the receiver task sets their
+ * levels from the ring before it hands them to the decoder
+ */
+static volatile struct {
+  int16_t pulses; // 0 for no train
+  bool wrapped;
+  unsigned long start;
+} streamedPending[RECEIVER_BUFFER_SIZE];
+#  endif
+#endif
+
 pulse_data_t* _pulseTrains;
 
 int rtl_433_ESP::messageCount = 0;
 int rtl_433_ESP::currentRssi = 0;
 int rtl_433_ESP::signalRssi = 0;
 int rtl_433_ESP::rssiThreshold = MINRSSI;
-bool rtl_433_ESP::_enabledReceiver = false;
+volatile bool rtl_433_ESP::_enabledReceiver = false;
 volatile uint8_t rtl_433_ESP::_actualPulseTrain = 0;
 uint8_t rtl_433_ESP::_avaiablePulseTrain = 0;
 volatile unsigned long rtl_433_ESP::_lastChange = 0; // Timestamp of previous edge
 int rtl_433_ESP::rtlVerbose = 0;
 volatile int16_t rtl_433_ESP::_nrpulses;
+#ifdef ISR_STATS
+volatile isr_stats_t rtl_433_ESP::isrStats = {};
+#endif
 
 // Variables for OOK Threshold auto calibrate function
 
 int rtl_433_ESP::totalSignals = 0;
 int rtl_433_ESP::ignoredSignals = 0;
 int rtl_433_ESP::unparsedSignals = 0;
+int rtl_433_ESP::decodedMessages = 0;
+int rtl_433_ESP::injectedSignals = 0;
 int signalRatio = 0;
 
+// Counts of injected trains, added to the signal counters by the receiver task
+static int injectTotal = 0;
+static int injectQueued = 0;
+static int injectIgnored = 0;
+
 // RSSI Threshold and average calculation
 
 int rtl_433_ESP::averageRssi = 0;
@@ -155,6 +264,7 @@ void rtl_433_ESP::initReceiver(byte inputPin, float receiveFrequency) {
 #endif
 
   rtlSetup();
+  updateSignalTiming();
 
 #ifdef MEMORY_DEBUG
   logprintfLn(LOG_INFO, "Post rtlSetup: %d", ESP.getFreeHeap());
@@ -303,6 +413,10 @@ void rtl_433_ESP::initReceiver(byte inputPin, float receiveFrequency) {
   logprintfLn(LOG_INFO, "Post config receivers: %d", ESP.getFreeHeap());
 #endif
 
+#ifdef AUTOTUNE
+  autotuneLoad();
+#endif
+
   // Receviers configured, start reception
 
 #if defined(RF_SX1276) || defined(RF_SX1278)
@@ -321,6 +435,9 @@ void rtl_433_ESP::initReceiver(byte inputPin, float receiveFrequency) {
 #endif
 
   if (!rtl_433_ReceiverHandle) {
+#ifdef AUTOTUNE
+    radioMutex = xSemaphoreCreateMutex();
+#endif
     xTaskCreatePinnedToCore(
         rtl_433_ESP::rtl_433_ReceiverTask, /* Function to implement the task */
         "rtl_433_ReceiverTask", /* Name of the task */
@@ -332,6 +449,35 @@ void rtl_433_ESP::initReceiver(byte inputPin, float receiveFrequency) {
   }
 }
 
+/**
+ * @brief Derive the signal timing from the enabled decoders, called again
+ * when the filters change the set of decoders
+ * 
+ */
+void rtl_433_ESP::updateSignalTiming() {
+#ifdef PROTOCOL_HANGOVER
+  unsigned int resetLimit = _maxResetLimit();
+  unsigned int minLength = _minSignalLength();
+  hangover = resetLimit && resetLimit < MINIMUM_SIGNAL_LENGTH ? resetLimit : MINIMUM_SIGNAL_LENGTH;
+  minSignalLength = minLength && minLength < MINIMUM_SIGNAL_LENGTH ? minLength : MINIMUM_SIGNAL_LENGTH;
+#  ifdef DEMOD_DEBUG
+  logprintfLn(LOG_INFO, "Signal hangover: %u, minimum signal length: %u", hangover, minSignalLength);
+#  endif
+#endif
+#ifdef STREAMING_DECODE
+  // a longer gap ends the whole signal in the receiver task, decoders
+  // with a larger reset_limit only see packets up to the end of the signal
+#  ifdef PROTOCOL_HANGOVER
+  splitGap = _maxResetLimit(hangover);
+#  else
+  splitGap = _maxResetLimit(MINIMUM_SIGNAL_LENGTH);
+#  endif
+#  ifdef DEMOD_DEBUG
+  logprintfLn(LOG_INFO, "Split gap: %u", splitGap);
+#  endif
+#endif
+}
+
 /**
  * @brief Is a signal available for decoding ?
  * 
@@ -351,53 +497,117 @@ int rtl_433_ESP::receivePulseTrain() {
  * 
  */
 void ICACHE_RAM_ATTR rtl_433_ESP::interruptHandler() {
+  // Time the edge with the cycle counter, micros() is too slow for every edge
+  const uint32_t cycles = ESP.getCycleCount();
+
   if (!_enabledReceiver || !receiveMode) {
     _noiseCount++;
-    return;
-  }
-  volatile pulse_data_t& pulseTrain = _pulseTrains[_actualPulseTrain];
-  volatile int* pulse = pulseTrain.pulse;
-  volatile int* gap = pulseTrain.gap;
+  } else {
+    volatile pulse_data_t& pulseTrain = _pulseTrains[_actualPulseTrain];
+    volatile int* pulse = pulseTrain.pulse;
+    volatile int* gap = pulseTrain.gap;
 #ifdef SIGNAL_RSSI
-  volatile int* rssi = pulseTrain.rssi;
+    volatile int* rssi = pulseTrain.rssi;
 #endif
+    int16_t nrpulses = _nrpulses;
 
-  const unsigned long now = micros();
-  const unsigned int duration = now - _lastChange;
+    const bool resync = _edgeResync;
+    const unsigned int duration = resync
+        ? micros() - _lastChange // first edge after signal start
+        : (cycles - _lastEdgeCycles) / cyclesPerMicro;
 
-  /* We first do some filtering (same as pilight BPF) */
+    /* We first do some filtering (same as pilight BPF) */
 
 #ifdef RF_CC1101
-  if (duration > MINIMUM_PULSE_LENGTH && currentRssi > rssiThreshold)
+    if (duration > MINIMUM_PULSE_LENGTH && currentRssi > rssiThreshold)
 #else
-  if (duration > MINIMUM_PULSE_LENGTH) // SX127X RSSI Value drops for a 0 value,
-  // and the OOK floor compensates for this
+    if (duration > MINIMUM_PULSE_LENGTH) // SX127X RSSI Value drops for a 0 value,
+    // and the OOK floor compensates for this
 #endif
-  {
+    {
 #ifdef SIGNAL_RSSI
-    rssi[_nrpulses] = currentRssi;
+      rssi[nrpulses] = currentRssi;
 #endif
-    if (!digitalRead(receiverGpio)) {
-      pulse[_nrpulses] = duration;
-
-      //      _nrpulses = (uint16_t)((_nrpulses + 1) % PD_MAX_PULSES);
-    } else {
-      if (pulse[_nrpulses] > 0) // Did we collect a + pulse ?
-      {
-        gap[_nrpulses] = duration;
-
-        _nrpulses = (uint16_t)((_nrpulses + 1) % PD_MAX_PULSES);
-      } else if (_nrpulses > 1) { // Have we received any data ?
-        // We received a random positive blib
-        gap[_nrpulses - 1] += duration;
+      if (resync)
+        TRACE(TRACE_EDGE_FIRST, nrpulses);
+#ifdef RTL_TRACE_EDGES
+      else
+        TRACE(TRACE_EDGE, nrpulses);
+#endif
+      bool next = false;
+      if (!(*receiverInReg & receiverInMask)) {
+        pulse[nrpulses] = duration;
       } else {
-        gap[_nrpulses] = duration;
-
-        _nrpulses = (uint16_t)((_nrpulses + 1) % PD_MAX_PULSES);
+        if (pulse[nrpulses] > 0) // Did we collect a + pulse ?
+        {
+          gap[nrpulses] = duration;
+          next = true;
+        } else if (nrpulses > 1) { // Have we received any data ?
+          // We received a random positive blib
+          gap[nrpulses - 1] += duration;
+        } else {
+          gap[nrpulses] = duration;
+          next = true;
+        }
       }
+      if (next && ++nrpulses >= PD_MAX_PULSES) {
+        nrpulses = 0;
+        TRACE(TRACE_PULSE_WRAP, 0);
+#ifdef ISR_STATS
+        isrStats.pulseWraps++;
+#endif
+#ifdef SIGNAL_RSSI
+        trainWrapped = true;
+#endif
+      }
+#ifdef STREAMING_DECODE
+      // No decoder bridges this gap, hand over the packets so far and
+      // continue the signal in the next train if it is free
+      if (next && splitGap && duration > splitGap && nrpulses > PD_MIN_PULSES) {
+        const uint8_t nextTrain = (_actualPulseTrain + 1) % RECEIVER_BUFFER_SIZE;
+        bool nextFree = _pulseTrains[nextTrain].num_pulses == 0;
+#ifdef SIGNAL_RSSI
+        nextFree = nextFree && streamedPending[nextTrain].pulses == 0;
+#endif
+        if (nextFree) {
+          const unsigned long now = micros();
+          pulseTrain.signalDuration = now - trainStart;
+          pulseTrain.signalRssi = signalRssi;
+#ifdef SIGNAL_RSSI
+          streamedPending[_actualPulseTrain].start = trainStart;
+          streamedPending[_actualPulseTrain].wrapped = trainWrapped;
+          streamedPending[_actualPulseTrain].pulses = nrpulses;
+          trainWrapped = false;
+#else
+          pulseTrain.num_pulses = nrpulses;
+#endif
+          TRACE(TRACE_TRAIN_SPLIT, nrpulses);
+          trainStart = now;
+          _actualPulseTrain = nextTrain;
+          nrpulses = 0;
+          streamedTrains++;
+        }
+      }
+#endif
+      _nrpulses = nrpulses;
+      _lastEdgeCycles = cycles;
+      if (resync)
+        _edgeResync = false;
+    }
+#ifdef ISR_STATS
+    else {
+      isrStats.shortEdges++;
     }
-    _lastChange = now;
+#endif
   }
+
+#ifdef ISR_STATS
+  const uint32_t isrCycles = ESP.getCycleCount() - cycles;
+  isrStats.calls++;
+  isrStats.totalCycles += isrCycles;
+  if (isrCycles > isrStats.maxCycles)
+    isrStats.maxCycles = isrCycles;
+#endif
 }
 
 /**
@@ -407,6 +617,9 @@ void ICACHE_RAM_ATTR rtl_433_ESP::interruptHandler() {
 void rtl_433_ESP::resetReceiver() {
   for (unsigned int i = 0; i < RECEIVER_BUFFER_SIZE; i++) {
     _pulseTrains[i].num_pulses = 0;
+#if defined(SIGNAL_RSSI) && defined(STREAMING_DECODE)
+    streamedPending[i].pulses = 0;
+#endif
   }
   _avaiablePulseTrain = 0;
   _actualPulseTrain = 0;
@@ -424,6 +637,18 @@ void rtl_433_ESP::resetReceiver() {
 void rtl_433_ESP::enableReceiver() {
   if (receiverGpio >= 0) {
     pinMode(receiverGpio, INPUT);
+#ifdef GPIO_IN1_REG
+    if (receiverGpio >= 32) {
+      receiverInReg = (volatile uint32_t*)GPIO_IN1_REG;
+      receiverInMask = 1UL << (receiverGpio - 32);
+    } else
+#endif
+    {
+      receiverInReg = (volatile uint32_t*)GPIO_IN_REG;
+      receiverInMask = 1UL << receiverGpio;
+    }
+    cyclesPerMicro = getCpuFrequencyMhz();
+    _edgeResync = true;
     attachInterrupt((uint8_t)receiverGpio, interruptHandler, CHANGE);
     _enabledReceiver = true;
   }
@@ -438,6 +663,233 @@ void rtl_433_ESP::disableReceiver() {
   detachInterrupt((uint8_t)receiverGpio);
 }
 
+#ifdef AUTOTUNE
+/*----------------------------- Receiver autotuning -----------------------------*/
+
+static autotune_t autotune;
+static bool autotuneRunning = false;
+static unsigned long autotuneTrialStart = 0;
+static unsigned long autotuneTrialMs = 0;
+static int autotuneMessages = 0;
+
+#  if defined(RF_SX1276) || defined(RF_SX1278)
+// SX127X only accepts these bandwidths, the bandwidth is tuned as an index
+static const float sx127xRxBandwidths[] = {2.6, 3.1, 3.9, 5.2, 6.3, 7.8, 10.4,
+                                           12.5, 15.6, 20.8, 25.0, 31.3, 41.7,
+                                           50.0, 62.5, 83.3, 100.0, 125.0,
+                                           166.7, 200.0, 250.0};
+#    define SX127X_RXBANDWIDTHS (sizeof(sx127xRxBandwidths) / sizeof(sx127xRxBandwidths[0]))
+
+static float sx127xRxBandwidthIndex(float bandwidth) {
+  unsigned i = 0;
+  while (i < SX127X_RXBANDWIDTHS - 1 && sx127xRxBandwidths[i] < bandwidth)
+    i++;
+  return i;
+}
+#  endif
+
+/**
+ * Messages that count towards the score, allow filters limit the score to
+ * known sensors
+ */
+static int autotuneMessageCount() {
+  r_filter_t* filter = _getFilter();
+  return rtl_433_ESP::decodedMessages - (filter ? filter->messages_filtered : 0);
+}
+
+/**
+ * Set up the tuned parameters for this transceiver and modulation, starting
+ * from the stored configuration
+ */
+static void autotuneSetup(Preferences& prefs) {
+  autotune_t* at = &autotune;
+  at->num_params = 0;
+  if (rtl_433_ESP::ookModulation) {
+#  if defined(RF_SX1276) || defined(RF_SX1278)
+    autotune_add_param(at, "bitRate", 1.2, 32.768, 4, 0.5, prefs.getFloat("bitRate", 1.2));
+    autotune_add_param(at, "rxBandwidth", 0, SX127X_RXBANDWIDTHS - 1, 4, 1, sx127xRxBandwidthIndex(prefs.getFloat("rxBandwidth", SX127X_RXBANDWIDTH)));
+#    ifndef AUTOOOKFIX // else AUTOOOKFIX owns the threshold
+    autotune_add_param(at, "ookThreshold", 6, 40, 4, 1, prefs.getFloat("ookThreshold", OOK_FIXED_THRESHOLD));
+#    endif
+#  else
+    autotune_add_param(at, "bitRate", 0.6, 250, 8, 0.5, prefs.getFloat("bitRate", 5.0)); // MDMCFG3/4 set 5 kbps
+    autotune_add_param(at, "rxBandwidth", 58, 812, 64, 8, prefs.getFloat("rxBandwidth", 812));
+#  endif
+  } else {
+    autotune_add_param(at, "bitRate", 1.2, 300, 8, 0.5, prefs.getFloat("bitRate", 17.24));
+    autotune_add_param(at, "freqDev", 5, 200, 16, 1, prefs.getFloat("freqDev", 40));
+#  if defined(RF_SX1276) || defined(RF_SX1278)
+    autotune_add_param(at, "rxBandwidth", 0, SX127X_RXBANDWIDTHS - 1, 4, 1, sx127xRxBandwidthIndex(prefs.getFloat("rxBandwidth", 83.3)));
+#  else
+    autotune_add_param(at, "rxBandwidth", 58, 812, 64, 8, prefs.getFloat("rxBandwidth", 270));
+#  endif
+  }
+#  ifdef AUTORSSITHRESHOLD
+  autotune_add_param(at, "rssiDelta", 2, 20, 2, 1, prefs.getFloat("rssiDelta", RSSI_THRESHOLD));
+#  endif
+}
+
+/**
+ * Apply the configuration in params[].value to the transceiver
+ */
+static int16_t autotuneConfigure(autotune_t const* at) {
+  int16_t state = RADIOLIB_ERR_NONE;
+  for (unsigned i = 0; i < at->num_params && state == RADIOLIB_ERR_NONE; ++i) {
+    autotune_param_t const* p = &at->params[i];
+    if (!strcmp(p->name, "bitRate")) {
+      state = radio.setBitRate(p->value);
+    } else if (!strcmp(p->name, "freqDev")) {
+      state = radio.setFrequencyDeviation(p->value);
+    } else if (!strcmp(p->name, "rxBandwidth")) {
+#  if defined(RF_SX1276) || defined(RF_SX1278)
+      state = radio.setRxBandwidth(sx127xRxBandwidths[(int)p->value]);
+#  else
+      state = radio.setRxBandwidth(p->value);
+#  endif
+    } else if (!strcmp(p->name, "ookThreshold")) {
+#  if defined(RF_SX1276) || defined(RF_SX1278)
+      rtl_433_ESP::OokFixedThreshold = p->value;
+      state = radio.setOokFixedOrFloorThreshold(rtl_433_ESP::OokFixedThreshold);
+#  endif
+    } else if (!strcmp(p->name, "rssiDelta")) {
+      rtl_433_ESP::rssiThresholdDelta = p->value;
+    }
+  }
+  if (state == RADIOLIB_ERR_NONE) {
+#  if defined(RF_SX1276) || defined(RF_SX1278)
+    state = radio.receiveDirect();
+#  else
+    state = radio.receiveDirectAsync();
+#  endif
+  }
+  return state;
+}
+
+/**
+ * Apply the configuration with the receiver task paused
+ */
+static int16_t autotuneApply(autotune_t const* at) {
+  if (radioMutex) // else the receiver task is not started
+    xSemaphoreTake(radioMutex, portMAX_DELAY);
+  int16_t state = autotuneConfigure(at);
+  if (radioMutex)
+    xSemaphoreGive(radioMutex);
+  return state;
+}
+
+static void autotuneLog(char const* msg) {
+  logprintf(LOG_INFO, "%s", msg);
+  for (unsigned i = 0; i < autotune.num_params; ++i) {
+    autotune_param_t const* p = &autotune.params[i];
+#  if defined(RF_SX1276) || defined(RF_SX1278)
+    if (!strcmp(p->name, "rxBandwidth")) {
+      alogprintf(LOG_INFO, ", %s: %.2f", p->name, sx127xRxBandwidths[(int)p->value]);
+      continue;
+    }
+#  endif
+    alogprintf(LOG_INFO, ", %s: %.2f", p->name, p->value);
+  }
+  alogprintfLn(LOG_INFO, " ");
+}
+
+/**
+ * Apply the stored configuration, if any
+ */
+static void autotuneLoad() {
+  Preferences prefs;
+  prefs.begin(rtl_433_ESP::ookModulation ? "rtl_433_ook" : "rtl_433_fsk", true);
+  bool stored = prefs.getBool("tuned", false);
+  autotuneSetup(prefs);
+  prefs.end();
+  if (stored) {
+    int16_t state = autotuneApply(&autotune);
+    RADIOLIB_STATE(state, "autotune stored configuration");
+    autotuneLog("Autotune stored configuration");
+  }
+}
+
+static void autotuneSave() {
+  Preferences prefs;
+  prefs.begin(rtl_433_ESP::ookModulation ? "rtl_433_ook" : "rtl_433_fsk", false);
+  for (unsigned i = 0; i < autotune.num_params; ++i) {
+    autotune_param_t const* p = &autotune.params[i];
+#  if defined(RF_SX1276) || defined(RF_SX1278)
+    if (!strcmp(p->name, "rxBandwidth")) {
+      prefs.putFloat(p->name, sx127xRxBandwidths[(int)p->value]);
+      continue;
+    }
+#  endif
+    prefs.putFloat(p->name, p->value);
+  }
+  prefs.putBool("tuned", true);
+  prefs.end();
+}
+
+/**
+ * Score the configuration once the trial time is over and move on to the
+ * next one
+ */
+static void autotuneLoop() {
+  unsigned long elapsed = millis() - autotuneTrialStart;
+  if (elapsed < autotuneTrialMs)
+    return;
+  float score = (autotuneMessageCount() - autotuneMessages) * 60000.0 / elapsed;
+  logprintfLn(LOG_INFO, "Autotune trial %u score: %.1f messages/min", autotune.trials + 1, score);
+
+  int more = autotune_next(&autotune, score);
+  while (more && autotuneApply(&autotune) != RADIOLIB_ERR_NONE) {
+    // configuration rejected by the transceiver, score it below any other
+    more = autotune_next(&autotune, -1);
+  }
+  if (more) {
+    autotuneLog("Autotune trying");
+  } else {
+    autotuneRunning = false;
+    autotuneApply(&autotune);
+    autotuneSave();
+    logprintfLn(LOG_INFO, "Autotune done after %u trials, best score: %.1f messages/min", autotune.trials, autotune.best_score);
+    autotuneLog("Autotune best configuration");
+  }
+  autotuneMessages = autotuneMessageCount();
+  autotuneTrialStart = millis();
+}
+
+/**
+ * @brief Start tuning the receiver parameters
+ * 
+ * @param trialSeconds - time each configuration is scored
+ */
+void rtl_433_ESP::startAutotune(int trialSeconds) {
+  Preferences prefs;
+  prefs.begin(ookModulation ? "rtl_433_ook" : "rtl_433_fsk", true);
+  autotuneSetup(prefs);
+  prefs.end();
+  autotune_init(&autotune, AUTOTUNE_MIN_GAIN, AUTOTUNE_MAX_TRIALS);
+  autotuneTrialMs = trialSeconds * 1000UL;
+  autotuneMessages = autotuneMessageCount();
+  autotuneTrialStart = millis();
+  autotuneRunning = true;
+  autotuneLog("Autotune starting");
+}
+
+/**
+ * @brief Stop tuning and return to the best configuration found so far, it is not stored
+ * 
+ */
+void rtl_433_ESP::stopAutotune() {
+  if (!autotuneRunning)
+    return;
+  autotuneRunning = false;
+  for (unsigned i = 0; i < autotune.num_params; ++i)
+    autotune.params[i].value = autotune.params[i].best;
+  autotuneApply(&autotune);
+}
+
+bool rtl_433_ESP::autotuneActive() {
+  return autotuneRunning;
+}
+#endif
+
 /**
  * @brief watch for completed signals being received, and pass to decoder logic
  * 
@@ -464,7 +916,6 @@ void rtl_433_ESP::loop() {
 #endif
       pulse_data_t* rtl_pulses = (pulse_data_t*)heap_caps_calloc(1, sizeof(pulse_data_t), MALLOC_CAP_INTERNAL);
       memcpy(rtl_pulses, (char*)&_pulseTrains[_receiveTrain], sizeof(pulse_data_t));
-      _pulseTrains[_receiveTrain].num_pulses = 0; // Make pulse train available for next train
       for (int x = 0; x < PD_MAX_PULSES; x++) {
         _pulseTrains[_receiveTrain].pulse[x] = 0;
         _pulseTrains[_receiveTrain].gap[x] = 0;
@@ -472,6 +923,10 @@ void rtl_433_ESP::loop() {
         _pulseTrains[_receiveTrain].rssi[x] = 0;
 #endif
       }
+      // Make pulse train available for next train, only once it is cleared
+      // as the interrupt handler may move on to it during a signal
+      _pulseTrains[_receiveTrain].num_pulses = 0;
+      TRACE(TRACE_TRAIN_COPY, rtl_pulses->num_pulses);
 #ifdef MEMORY_DEBUG
       logprintfLn(LOG_INFO, "Post copy out of train: %d", ESP.getFreeHeap());
 #endif
@@ -480,6 +935,7 @@ void rtl_433_ESP::loop() {
         processSignal(rtl_pulses); // send received signal for decoding
       } else {
         ignoredSignals++;
+        TRACE(TRACE_TRAIN_DROPPED, TRACE_DROP_SHORT);
 #ifdef MEMORY_DEBUG
         logprintfLn(LOG_INFO, "Pre free copy out of train: %d",
                     ESP.getFreeHeap());
@@ -496,26 +952,31 @@ void rtl_433_ESP::loop() {
 
     if ((totalSignals % 100) == 0 && totalSignals != 0) {
 #ifdef AUTOOOKFIX
+#  ifdef AUTOTUNE
+      if (!autotuneRunning) // the trial sets its own threshold
+#  endif
+      {
 #  if defined(RF_SX1276) || defined(RF_SX1278)
-      OokFixedThreshold = _mod->SPIreadRegister(RADIOLIB_SX127X_REG_OOK_FIX);
+        OokFixedThreshold = _mod->SPIreadRegister(RADIOLIB_SX127X_REG_OOK_FIX);
 #    ifdef REGOOKFIX_DEBUG
-      logprintfLn(LOG_DEBUG,
-                  "RegOokFix Threshold Adjust ignoredSignals %d, "
-                  "unparsedSignals %d, totalSignals %d, RegOokFix 0x%.2x",
-                  ignoredSignals, unparsedSignals, totalSignals,
-                  OokFixedThreshold);
+        logprintfLn(LOG_DEBUG,
+                    "RegOokFix Threshold Adjust ignoredSignals %d, "
+                    "unparsedSignals %d, totalSignals %d, RegOokFix 0x%.2x",
+                    ignoredSignals, unparsedSignals, totalSignals,
+                    OokFixedThreshold);
 #    endif
-      if (ignoredSignals >
-          unparsedSignals) // too many ignored decrement threshold
-      {
-        int state = radio.setOokFixedOrFloorThreshold(--OokFixedThreshold);
-        RADIOLIB_STATE(state, "OokFixedThreshold");
+        if (ignoredSignals >
+            unparsedSignals) // too many ignored decrement threshold
+        {
+          int state = radio.setOokFixedOrFloorThreshold(--OokFixedThreshold);
+          RADIOLIB_STATE(state, "OokFixedThreshold");
 #    ifdef REGOOKFIX_DEBUG
-        logprintfLn(LOG_DEBUG, "RegOokFix Threshold Decremented to 0x%.2x",
-                    _mod->SPIreadRegister(RADIOLIB_SX127X_REG_OOK_FIX));
+          logprintfLn(LOG_DEBUG, "RegOokFix Threshold Decremented to 0x%.2x",
+                      _mod->SPIreadRegister(RADIOLIB_SX127X_REG_OOK_FIX));
 #    endif
-      }
+        }
 #  endif
+      }
 #endif
       signalRatio = (totalSignals - (ignoredSignals + unparsedSignals)) / totalSignals * 100;
 
@@ -523,6 +984,10 @@ void rtl_433_ESP::loop() {
       ignoredSignals = 0;
       unparsedSignals = 0;
     }
+#ifdef AUTOTUNE
+    if (autotuneRunning)
+      autotuneLoop();
+#endif
   }
   vTaskDelay(1);
 }
@@ -533,11 +998,47 @@ void rtl_433_ESP::loop() {
  * @param pvParameters 
  */
 void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
+#ifdef PROTOCOL_HANGOVER
+  int16_t lastPulses = 0;
+#endif
+#ifdef STREAMING_DECODE
+  uint32_t streamedCounted = 0;
+#endif
   for (;;) {
+    // injected trains, counted here as the injecting task would race these counters
+    totalSignals += __atomic_exchange_n(&injectTotal, 0, __ATOMIC_RELAXED);
+    messageCount += __atomic_exchange_n(&injectQueued, 0, __ATOMIC_RELAXED);
+    ignoredSignals += __atomic_exchange_n(&injectIgnored, 0, __ATOMIC_RELAXED);
+#ifdef STREAMING_DECODE
+    // trains split off by the interrupt handler
+    const uint32_t streamed = streamedTrains;
+    totalSignals += streamed - streamedCounted;
+    messageCount += streamed - streamedCounted;
+    streamedCounted = streamed;
+#  ifdef SIGNAL_RSSI
+    for (unsigned int i = 0; i < RECEIVER_BUFFER_SIZE; i++) {
+      const int16_t pulses = streamedPending[i].pulses;
+      if (!pulses)
+        continue;
+      if (!streamedPending[i].wrapped)
+        rssi_ring_apply(&rssiRing, &_pulseTrains[i], pulses, streamedPending[i].start);
+      _pulseTrains[i].num_pulses = pulses;
+      streamedPending[i].pulses = 0;
+    }
+#  endif
+#endif
+
+#ifdef AUTOTUNE
+    xSemaphoreTake(radioMutex, portMAX_DELAY);
+#endif
     if (_enabledReceiver) {
       // Calculate average RSSI signal level in environment
 
       currentRssi = _getRSSI();
+#ifdef SIGNAL_RSSI
+      // with the data pin, a sample of a gap is not the level of a pulse
+      rssi_ring_push(&rssiRing, micros(), currentRssi, *receiverInReg & receiverInMask);
+#endif
       _rssiCount++;
       _totalRssi += currentRssi;
 
@@ -557,38 +1058,68 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
         _rssiCount = 0;
       }
 
+#ifdef PROTOCOL_HANGOVER
+      if (receiveMode && _nrpulses != lastPulses) {
+        lastPulses = _nrpulses;
+        lastEdge = micros();
+      }
+#endif
+
       if (currentRssi > rssiThreshold) // A signal is present
       {
         if (!receiveMode) {
           receiveMode = true;
           signalStart = micros();
+          TRACE(TRACE_SIGNAL_START, currentRssi);
 #ifdef ONBOARD_LED
           digitalWrite(ONBOARD_LED, HIGH);
 #endif
           signalRssi = currentRssi;
           _lastChange = micros();
+          _edgeResync = true;
+#ifdef STREAMING_DECODE
+          trainStart = signalStart;
+#endif
+#ifdef SIGNAL_RSSI
+          trainWrapped = false;
+#endif
+#ifdef PROTOCOL_HANGOVER
+          lastEdge = signalStart;
+          lastPulses = 0;
+#endif
 
           if (_noiseCount > 100) {
 #ifdef AUTOOOKFIX
+#  ifdef AUTOTUNE
+            if (!autotuneRunning) // the trial sets its own threshold
+#  endif
+            {
 #  if defined(RF_SX1276) || defined(RF_SX1278)
-            OokFixedThreshold =
-                _mod->SPIreadRegister(RADIOLIB_SX127X_REG_OOK_FIX);
+              OokFixedThreshold =
+                  _mod->SPIreadRegister(RADIOLIB_SX127X_REG_OOK_FIX);
 #    ifdef REGOOKFIX_DEBUG
-            logprintfLn(
-                LOG_DEBUG,
-                "RegOokFix Threshold Adjust noise count %d, RegOokFix 0x%.2x",
-                _noiseCount, OokFixedThreshold);
+              logprintfLn(
+                  LOG_DEBUG,
+                  "RegOokFix Threshold Adjust noise count %d, RegOokFix 0x%.2x",
+                  _noiseCount, OokFixedThreshold);
 #    endif
-            int state = radio.setOokFixedOrFloorThreshold(++OokFixedThreshold);
-            RADIOLIB_STATE(state, "OokFixedThreshold");
+              int state = radio.setOokFixedOrFloorThreshold(++OokFixedThreshold);
+              RADIOLIB_STATE(state, "OokFixedThreshold");
 #  endif
+            }
 #endif
             _noiseCount = 0;
           }
         }
         signalEnd = micros();
       }
-#if defined(RF_SX1276) || defined(RF_SX1278)
+#ifdef PROTOCOL_HANGOVER
+      // If the signal strength dropped but the signal or its edges stopped
+      // for less than the hangover keep the receiver running, edges alone
+      // for at most MINIMUM_SIGNAL_LENGTH
+      else if (micros() - signalEnd < hangover ||
+               (micros() - lastEdge < hangover && micros() - signalEnd < MINIMUM_SIGNAL_LENGTH))
+#elif defined(RF_SX1276) || defined(RF_SX1278)
       // If we received a signal but had a minor drop in strength keep the
       // receiver running for an additional 150,000
       else if (micros() - signalEnd < MINIMUM_SIGNAL_LENGTH)
@@ -609,14 +1140,36 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
 #endif
           receiveMode = false;
           totalSignals++;
+#ifdef PROTOCOL_HANGOVER
+          if ((_nrpulses > PD_MIN_PULSES) &&
+              ((signalEnd - signalStart) > minSignalLength))
+#else
           if ((_nrpulses > PD_MIN_PULSES) &&
               ((signalEnd - signalStart) >
                MINIMUM_SIGNAL_LENGTH)) // Minimum signal length of MINIMUM_SIGNAL_LENGTH MS
+#endif
           {
+#ifdef SIGNAL_RSSI
+            // the level in the middle of each pulse instead of the last sample
+            // before its edge, the timeline of a wrapped train is lost
+            if (!trainWrapped) {
+#  ifdef STREAMING_DECODE
+              rssi_ring_apply(&rssiRing, &_pulseTrains[_actualPulseTrain], _nrpulses + 1, trainStart);
+#  else
+              rssi_ring_apply(&rssiRing, &_pulseTrains[_actualPulseTrain], _nrpulses + 1, signalStart);
+#  endif
+            }
+#endif
             _pulseTrains[_actualPulseTrain].num_pulses = _nrpulses + 1;
+#ifdef STREAMING_DECODE
+            _pulseTrains[_actualPulseTrain].signalDuration =
+                signalEnd - trainStart;
+#else
             _pulseTrains[_actualPulseTrain].signalDuration =
                 signalEnd - signalStart;
+#endif
             _pulseTrains[_actualPulseTrain].signalRssi = signalRssi;
+            TRACE(TRACE_SIGNAL_END, _nrpulses + 1);
 #ifdef DEMOD_DEBUG
             logprintf(LOG_INFO, "Signal length: %lu",
                       _pulseTrains[_actualPulseTrain].signalDuration);
@@ -633,6 +1186,7 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
             _nrpulses = 0;
           } else {
             ignoredSignals++;
+            TRACE(TRACE_SIGNAL_IGNORED, _nrpulses);
 #ifdef DEMOD_DEBUG
             if (micros() - signalStart > 1000) {
               logprintf(LOG_INFO, "Ignored Signal length: %lu",
@@ -657,6 +1211,9 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
         }
       }
     }
+#ifdef AUTOTUNE
+    xSemaphoreGive(radioMutex);
+#endif
     vTaskDelay(1);
   }
 }
@@ -668,19 +1225,25 @@ void rtl_433_ESP::rtl_433_ReceiverTask(void* pvParameters) {
  * @param messageBuffer 
  * @param bufferSize 
  */
-rtl_433_ESPCallBack _callback; // TODO: Use global object
-char* _messageBuffer;
-int _bufferSize;
-
 void rtl_433_ESP::setCallback(rtl_433_ESPCallBack callback, char* messageBuffer,
                               int bufferSize) {
   // logprintfLn(LOG_DEBUG, "rtl_433_ESP::setCallback location: %p", callback);
-  _callback = callback;
-  _messageBuffer = messageBuffer;
-  _bufferSize = bufferSize;
   _setCallback(callback, messageBuffer, bufferSize);
 }
 
+/**
+ * @brief Client callback to receive decoded signals in the selected encoding
+ * 
+ * @param callback 
+ * @param messageBuffer 
+ * @param bufferSize 
+ * @param encoding - RTL_433_CBOR or RTL_433_JSON
+ */
+void rtl_433_ESP::setCallback(rtl_433_ESPTypedCallBack callback, uint8_t* messageBuffer,
+                              int bufferSize, int encoding) {
+  _setTypedCallback(callback, messageBuffer, bufferSize, encoding);
+}
+
 /**
  * @brief Set delta applied to average RSSI level for determining start and end of signal
  * 
@@ -723,6 +1286,148 @@ void rtl_433_ESP::setDebug(int debug) {
   logprintfLn(LOG_INFO, "Setting rtl_433 debug to: %d", rtlVerbose);
 }
 
+/**
+ * @brief Add a message filter rule
+ * 
+ * @param rule - "[!]key=value", key is protocol, model, id or channel
+ * @return true if the rule was added
+ */
+bool rtl_433_ESP::addFilter(const char* rule) {
+  bool added = _addFilter(rule);
+  updateSignalTiming();
+  return added;
+}
+
+/**
+ * @brief Drop signals below a minimum RSSI before decoding
+ * 
+ * @param minRssi 
+ */
+void rtl_433_ESP::setFilterMinRssi(int minRssi) {
+  _setFilterMinRssi(minRssi);
+}
+
+#ifdef NOISE_FILTER
+/**
+ * @brief Set the noise filter level and sampling of rejected trains
+ * 
+ * @param level - 0 off, 1 conservative, 2 moderate, 3 aggressive
+ * @param sampleEvery - decode every nth rejected train, 0 for none
+ */
+void rtl_433_ESP::setNoiseFilter(int level, int sampleEvery) {
+  _setNoiseFilter(level, sampleEvery);
+}
+#endif
+
+#ifdef SCHEDULE_LEARNER
+/**
+ * @brief Output the learned transmission schedule and packet loss of each device
+ * 
+ */
+void rtl_433_ESP::getScheduleStatus() {
+  _outputSchedule();
+}
+#endif
+
+#ifdef DECODER_PROFILE
+/**
+ * @brief Log the stack profile of the decoders
+ * 
+ */
+void rtl_433_ESP::printDecoderProfile() {
+  _printDecoderProfile();
+}
+#endif
+
+#ifdef RTL_TRACE
+/**
+ * @brief Log the event trace ring and clear it
+ * 
+ */
+void rtl_433_ESP::dumpTrace() {
+  _dumpTrace();
+}
+#endif
+
+#ifdef FLEX_ANALYZER
+/**
+ * @brief Analyze undecoded trains and report a flex decoder specification
+ * 
+ * @param trains - undecoded trains to collect
+ * @param minPulses - shorter trains are skipped
+ */
+void rtl_433_ESP::startFlexAnalyzer(int trains, int minPulses) {
+  _startFlexAnalyzer(trains, minPulses);
+}
+
+/**
+ * @brief Stop the flex analyzer and report the trains collected so far
+ * 
+ */
+void rtl_433_ESP::stopFlexAnalyzer() {
+  _stopFlexAnalyzer();
+}
+#endif
+
+/**
+ * @brief Remove all message filter rules
+ * 
+ */
+void rtl_433_ESP::clearFilters() {
+  _clearFilters();
+  updateSignalTiming();
+}
+
+/**
+ * @brief Queue a pulse train for decoding, counted as a received signal
+ * 
+ * @param pulses widths in us, copied
+ * @param waitMs wait for a free decoder queue slot
+ * @return true if queued
+ */
+bool rtl_433_ESP::injectPulseTrain(const pulse_data_t* pulses, int waitMs) {
+  __atomic_fetch_add(&injectTotal, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&injectedSignals, 1, __ATOMIC_RELAXED);
+  if (pulses->num_pulses <= PD_MIN_PULSES) {
+    __atomic_fetch_add(&injectIgnored, 1, __ATOMIC_RELAXED);
+    TRACE(TRACE_TRAIN_DROPPED, TRACE_DROP_SHORT);
+    return false;
+  }
+  pulse_data_t* rtl_pulses = (pulse_data_t*)heap_caps_malloc(sizeof(pulse_data_t), MALLOC_CAP_INTERNAL);
+  if (!rtl_pulses) {
+    logprintfLn(LOG_ERR, "ERROR: no memory to inject a signal");
+    return false;
+  }
+  __atomic_fetch_add(&injectQueued, 1, __ATOMIC_RELAXED);
+  memcpy(rtl_pulses, pulses, sizeof(pulse_data_t));
+  rtl_pulses->noiseSample = 0;
+  rtl_pulses->classes = NULL; // the caller's, built again by the decoder task
+  pulse_inject_prepare(rtl_pulses);
+  TRACE(TRACE_TRAIN_COPY, rtl_pulses->num_pulses);
+  return processSignal(rtl_pulses, pdMS_TO_TICKS(waitMs)) == 0;
+}
+
+/**
+ * @brief Queue the pulse trains of an OOK text, RfRaw or pulse string for decoding
+ * 
+ * @param text one or more trains
+ * @param waitMs wait for a free decoder queue slot, per train
+ * @return the number of trains queued
+ */
+int rtl_433_ESP::injectPulseText(const char* text, int waitMs) {
+  // too large for the stack of the caller
+  pulse_data_t* pulses = (pulse_data_t*)malloc(sizeof(pulse_data_t));
+  if (!pulses) {
+    logprintfLn(LOG_ERR, "ERROR: no memory to inject a signal");
+    return 0;
+  }
+  int queued = 0;
+  while (text && (text = pulse_inject_parse(pulses, text)))
+    queued += injectPulseTrain(pulses, waitMs);
+  free(pulses);
+  return queued;
+}
+
 /**
  * @brief Send RTL_433_ESP status to serial port and client. Also send to serial port transceiver status.
  * 
@@ -747,9 +1452,26 @@ void rtl_433_ESP::getStatus() {
   alogprintf(LOG_INFO, ", StackHWM: %d", uxTaskGetStackHighWaterMark(NULL));
   alogprintf(LOG_INFO, ", RTL_HWM: %d", uxTaskGetStackHighWaterMark(rtl_433_ReceiverHandle));
   alogprintf(LOG_INFO, ", DCD_HWM: %d", uxTaskGetStackHighWaterMark(rtl_433_DecoderHandle));
-  alogprintfLn(LOG_INFO, ", pulses: %d", _nrpulses);
+  alogprintf(LOG_INFO, ", pulses: %d", _nrpulses);
+#ifdef ISR_STATS
+  alogprintf(LOG_INFO, ", isrCalls: %u", (unsigned)isrStats.calls);
+  alogprintf(LOG_INFO, ", isrMaxCycles: %u", (unsigned)isrStats.maxCycles);
+  alogprintf(LOG_INFO, ", pulseWraps: %u", (unsigned)isrStats.pulseWraps);
+  alogprintf(LOG_INFO, ", shortEdges: %u", (unsigned)isrStats.shortEdges);
+#endif
+  alogprintfLn(LOG_INFO, " ");
 
   data_t* data;
+  r_filter_t* filter = _getFilter();
+  fp_cache_t* fpCache = _getFingerprintCache();
+  r_schedule_t* schedule = _getSchedule();
+  noise_filter_t* noise = _getNoiseFilter();
+  pulse_separator_t* separator = _getSeparator();
+  unsigned recommendedStack = _recommendedDecoderStack();
+#ifdef SEARCH_INDEX
+  unsigned searchPatterns, searchAnswered, searchScanned;
+  bitbuffer_index_stats(&searchPatterns, &searchAnswered, &searchScanned);
+#endif
 
   /* clang-format off */
   data = data_make(
@@ -771,19 +1493,52 @@ void rtl_433_ESP::getStatus() {
                 "signalRatio",    "", DATA_INT, signalRatio,
                 "ignoredSignals", "", DATA_INT, ignoredSignals,
                 "unparsedSignals", "", DATA_INT, unparsedSignals,
+                "injectedSignals", "", DATA_COND, injectedSignals > 0, DATA_INT, injectedSignals,
+                "filteredSignals", "", DATA_COND, filter != NULL, DATA_INT, filter ? filter->signals_filtered : 0,
+                "filteredMessages", "", DATA_COND, filter != NULL, DATA_INT, filter ? filter->messages_filtered : 0,
+                "fpHits",         "", DATA_COND, fpCache != NULL, DATA_INT, fpCache ? fpCache->hits : 0,
+                "fpMisses",       "", DATA_COND, fpCache != NULL, DATA_INT, fpCache ? fpCache->misses : 0,
+                "fpStale",        "", DATA_COND, fpCache != NULL, DATA_INT, fpCache ? fpCache->stale : 0,
+                "schedHits",      "", DATA_COND, schedule != NULL, DATA_INT, schedule ? schedule->hits : 0,
+                "schedMisses",    "", DATA_COND, schedule != NULL, DATA_INT, schedule ? schedule->misses : 0,
+                "schedDevices",   "", DATA_COND, schedule != NULL, DATA_INT, schedule ? r_schedule_learned(schedule) : 0,
+                "noiseRejected",  "", DATA_COND, noise != NULL, DATA_INT, noise ? noise->rejected : 0,
+                "noiseSampled",   "", DATA_COND, noise != NULL, DATA_INT, noise ? noise->sampled : 0,
+                "noiseMissed",    "", DATA_COND, noise != NULL, DATA_INT, noise ? noise->missed : 0,
+                "separatedSignals", "", DATA_COND, separator != NULL, DATA_INT, separator ? separator->split : 0,
+                "separatedDecoded", "", DATA_COND, separator != NULL, DATA_INT, separator ? separator->decoded : 0,
                 "StackHWM",       "", DATA_INT, uxTaskGetStackHighWaterMark(NULL),
                 "RTL_HWM",        "", DATA_INT, uxTaskGetStackHighWaterMark(rtl_433_ReceiverHandle),
                 "DCD_HWM",        "", DATA_INT, uxTaskGetStackHighWaterMark(rtl_433_DecoderHandle),
+                "DCD_Recommended", "", DATA_COND, recommendedStack, DATA_INT, recommendedStack,
                 "freeMem",        "", DATA_INT, ESP.getFreeHeap(),
+#ifdef STREAMING_DECODE
+                "streamedTrains", "", DATA_INT, streamedTrains,
+#endif
+#ifdef SEARCH_INDEX
+                "searchPatterns", "", DATA_INT, searchPatterns,
+                "searchAnswered", "", DATA_INT, searchAnswered,
+                "searchScanned",  "", DATA_INT, searchScanned,
+#endif
+#ifdef PROTOCOL_HANGOVER
+                "hangover",       "", DATA_INT, hangover,
+                "minSignalLength", "", DATA_INT, minSignalLength,
+#endif
                 "_enabledReceiver", "", DATA_INT, _enabledReceiver,
                 "receiveMode",    "", DATA_INT, receiveMode,
+#ifdef ISR_STATS
+                "isrCalls",       "", DATA_INT, isrStats.calls,
+                "isrMaxUs",       "", DATA_DOUBLE, (double)isrStats.maxCycles / cyclesPerMicro,
+                "isrMeanUs",      "", DATA_DOUBLE, isrStats.calls ? (double)isrStats.totalCycles / isrStats.calls / cyclesPerMicro : 0.0,
+                "pulseWraps",     "", DATA_INT, isrStats.pulseWraps,
+                "shortEdges",     "", DATA_INT, isrStats.shortEdges,
+#endif
                 NULL);
 #ifdef RF_MODULE_INIT_STATUS
   getModuleStatus();
 #endif
 
-  data_print_jsons(data, _messageBuffer, _bufferSize);
-  (_callback)(_messageBuffer);
+  _outputMessage(data);
   data_free(data);
 }
 
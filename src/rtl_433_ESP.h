@@ -46,6 +46,21 @@
 
 /*----------------------------- Optional Compiler Definitions -----------------------------*/
 
+struct pulse_data;
+
+#ifdef ISR_STATS
+/**
+ * Interrupt handler instrumentation
+ */
+typedef struct {
+  uint32_t calls; // edges seen, including edges while not receiving
+  uint32_t maxCycles; // longest handler run in cpu cycles
+  uint64_t totalCycles; // cpu cycles spent in the handler
+  uint32_t pulseWraps; // pulse buffer overruns, _nrpulses wrapped at PD_MAX_PULSES
+  uint32_t shortEdges; // edges rejected by MINIMUM_PULSE_LENGTH
+} isr_stats_t;
+#endif
+
 #ifndef ONBOARD_LED
 // #define ONBOARD_LED -1
 #endif
@@ -59,6 +74,37 @@
 #  define DEAF_WORKAROUND
 #endif
 
+// Cluster pulse widths once per signal and share the classes between decoders
+#ifndef NO_PULSE_CLASSES
+#  define PULSE_CLASSES
+#endif
+
+// Try the decoders that decoded the same pulse train recently first, needs PULSE_CLASSES
+#if defined(PULSE_CLASSES) && !defined(NO_FINGERPRINT_CACHE)
+#  define FINGERPRINT_CACHE
+#endif
+
+// Learn the transmission period of each device and try the decoders of expected devices first
+#ifndef NO_SCHEDULE_LEARNER
+#  define SCHEDULE_LEARNER
+#endif
+
+// Drop noise trains before they are queued for decoding
+#ifndef NO_NOISE_FILTER
+#  define NOISE_FILTER
+#endif
+
+#ifdef NOISE_FILTER
+// Noise filter level, 0 off, 1 conservative, 2 moderate, 3 aggressive
+#  ifndef NOISE_FILTER_LEVEL
+#    define NOISE_FILTER_LEVEL 1
+#  endif
+// Decode every nth rejected train as a sample, 0 for none
+#  ifndef NOISE_FILTER_SAMPLE
+#    define NOISE_FILTER_SAMPLE 32
+#  endif
+#endif
+
 // Number of rssi results to collect for average calculation
 #ifndef RSSI_SAMPLES
 #  define RSSI_SAMPLES 50000
@@ -76,6 +122,39 @@
 
 // #define AUTOOOKFIX true      // Has shown to be problematic
 
+#ifdef AUTOTUNE
+// Seconds each configuration is scored during receiver autotuning
+#  ifndef AUTOTUNE_TRIAL_SECONDS
+#    define AUTOTUNE_TRIAL_SECONDS 120
+#  endif
+// Improvement in messages per minute needed to accept a configuration
+#  ifndef AUTOTUNE_MIN_GAIN
+#    define AUTOTUNE_MIN_GAIN 0.5
+#  endif
+// Limit on the number of configurations tried
+#  ifndef AUTOTUNE_MAX_TRIALS
+#    define AUTOTUNE_MAX_TRIALS 100
+#  endif
+#endif
+
+#ifdef DECODER_PROFILE
+// Decoder task stack reserved on top of the profiled depth for the unparsed signal path
+#  ifndef DECODER_PROFILE_RESERVE
+#    define DECODER_PROFILE_RESERVE 1024
+#  endif
+#endif
+
+#ifdef FLEX_ANALYZER
+// Undecoded trains collected before the flex analyzer reports
+#  ifndef FLEX_ANALYZER_TRAINS
+#    define FLEX_ANALYZER_TRAINS 10
+#  endif
+// Shorter undecoded trains are not analyzed
+#  ifndef FLEX_ANALYZER_MIN_PULSES
+#    define FLEX_ANALYZER_MIN_PULSES 24
+#  endif
+#endif
+
 // Pulse train buffer count
 #define RECEIVER_BUFFER_SIZE 2
 
@@ -227,6 +306,21 @@
  */
 typedef void (*rtl_433_ESPCallBack)(char* message);
 
+/**
+ * Message encodings of the typed message callback
+ */
+enum rtl_433_encoding {
+  RTL_433_JSON = 0, // JSON text, nul terminated
+  RTL_433_CBOR = 1, // CBOR ( RFC 8949 ) map
+};
+
+/**
+ * message  - encoded message from device
+ * length   - length of message in bytes, without the nul of JSON
+ * encoding - RTL_433_JSON or RTL_433_CBOR
+ */
+typedef void (*rtl_433_ESPTypedCallBack)(const uint8_t* message, size_t length, int encoding);
+
 typedef std::function<void(const uint16_t* pulses, size_t length)>
     PulseTrainCallBack;
 
@@ -257,6 +351,22 @@ public:
   void setCallback(rtl_433_ESPCallBack callback, char* messageBuffer,
                    int bufferSize);
 
+  /**
+   * Set message received callback function with a selectable encoding
+   *
+   * callback      - message received function callback
+   * messageBuffer - message received buffer
+   * bufferSize    - size of message received buffer
+   * encoding      - RTL_433_CBOR or RTL_433_JSON
+   *
+   * callback function signature
+   *
+   * (const uint8_t* message, size_t length, int encoding)
+   * Messages that do not fit into the buffer are dropped with CBOR.
+   */
+  void setCallback(rtl_433_ESPTypedCallBack callback, uint8_t* messageBuffer,
+                   int bufferSize, int encoding = RTL_433_CBOR);
+
   /**
    * Set minimum RSSI value for receiver
    */
@@ -307,6 +417,118 @@ public:
 
   static void getModuleStatus();
 
+  /**
+   * Add a message filter rule, evaluated before any output work is done
+   *
+   * rule - "[!]key=value" where key is protocol, model, id or channel.
+   *        A leading '!' drops matching messages, otherwise only matching
+   *        messages are passed. protocol takes the decoder name or number.
+   *
+   * Returns false if the rule is invalid or the rule table is full
+   */
+  static bool addFilter(const char* rule);
+
+  /**
+   * Drop signals with an RSSI below minRssi before they are decoded
+   */
+  static void setFilterMinRssi(int minRssi);
+
+  /**
+   * Remove all message filter rules and the minimum RSSI
+   */
+  static void clearFilters();
+
+  /**
+   * Queue a pulse train for decoding as if it was received, it is counted,
+   * filtered and decoded like a captured train, with the decoders of the
+   * current modulation
+   *
+   * pulses - pulse and gap widths in us, copied. A signalDuration of 0 is
+   *          taken from the widths.
+   * waitMs - how long to wait for a free slot of the decoder queue
+   *
+   * Returns false if the train was too short, filtered or the queue was full
+   */
+  static bool injectPulseTrain(const struct pulse_data* pulses, int waitMs = 0);
+
+  /**
+   * Queue the pulse trains of a text for decoding, see injectPulseTrain()
+   *
+   * text   - OOK text as written by rtl_433 -w, RfRaw ( "AAB0...55" ) or
+   *          "+pulse-gap..." lines, widths in us
+   * waitMs - how long to wait for a free slot of the decoder queue, per train
+   *
+   * Returns the number of trains queued
+   */
+  static int injectPulseText(const char* text, int waitMs = 0);
+#ifdef NOISE_FILTER
+  /**
+   * Set the noise filter, trains with random pulse widths are dropped
+   * before they are queued for decoding
+   *
+   * level       - 0 off, 1 conservative, 2 moderate, 3 aggressive
+   * sampleEvery - decode every nth rejected train to check the filter,
+   *               0 for none
+   */
+  static void setNoiseFilter(int level, int sampleEvery = NOISE_FILTER_SAMPLE);
+#endif
+
+#ifdef SCHEDULE_LEARNER
+  /**
+   * Output a message for each device of the transmission schedule with the
+   * learned period, the transmissions received and missed and the packet
+   * loss in percent
+   */
+  static void getScheduleStatus();
+#endif
+
+#ifdef AUTOTUNE
+  /**
+   * Tune bit rate, bandwidth, deviation, OOK threshold and RSSI delta by
+   * scoring each configuration with the messages decoded during trialSeconds.
+   * The best configuration is applied and stored, and restored by initReceiver.
+   */
+  static void startAutotune(int trialSeconds = AUTOTUNE_TRIAL_SECONDS);
+
+  /**
+   * Stop tuning and apply the best configuration found so far without storing it
+   */
+  static void stopAutotune();
+
+  static bool autotuneActive();
+#endif
+
+#ifdef DECODER_PROFILE
+  /**
+   * Log the deepest stack use of each decoder and the rtl_433_Decoder_Stack
+   * recommended for the enabled decoders
+   */
+  static void printDecoderProfile();
+#endif
+
+#ifdef RTL_TRACE
+  /**
+   * Log the event trace ring as hex lines and clear it, convert the log
+   * with tools/trace_convert.c
+   */
+  static void dumpTrace();
+#endif
+
+#ifdef FLEX_ANALYZER
+  /**
+   * Analyze the next undecoded trains with at least minPulses pulses and
+   * report the modulation, timing and a flex decoder specification through
+   * the message callback after trains trains
+   */
+  static void startFlexAnalyzer(int trains = FLEX_ANALYZER_TRAINS,
+                                int minPulses = FLEX_ANALYZER_MIN_PULSES);
+
+  /**
+   * Stop analyzing and report the trains collected so far
+   */
+  static void stopFlexAnalyzer();
+#endif
+
   /**
    * Number of messages received since most recent device startup
    */
@@ -331,6 +553,13 @@ public:
 
   static int averageRssi;
 
+#ifdef ISR_STATS
+  /**
+   * Interrupt handler counters, reported in the status message
+   */
+  static volatile isr_stats_t isrStats;
+#endif
+
   /**
    * Functions used during testing
    */
@@ -356,6 +585,8 @@ public:
   static int totalSignals;
   static int ignoredSignals;
   static int unparsedSignals;
+  static int decodedMessages;
+  static int injectedSignals;
 
   static uint8_t OokFixedThreshold;
 
@@ -404,6 +635,12 @@ private:
    */
   static void resetReceiver();
 
+  /**
+   * Derive signal timing from the enabled decoders, the split gap of
+   * STREAMING_DECODE and the hangover of PROTOCOL_HANGOVER
+   */
+  static void updateSignalTiming();
+
   static int _getRSSI();
 
   /**
@@ -416,7 +653,7 @@ private:
    * _enabledReceiver: If true, monitoring and decoding is enabled.
    * If false, interruptHandler will return immediately.
    */
-  static bool _enabledReceiver;
+  static volatile bool _enabledReceiver;
   // static volatile pulse_data_t _pulseTrains[];
   static volatile uint8_t _actualPulseTrain;
   static uint8_t _avaiablePulseTrain;
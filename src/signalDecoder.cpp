@@ -48,8 +48,41 @@
 
 int rtlVerbose = 0;
 
+#ifdef PULSE_CLASSES
+static pulse_classes_t pulseClasses;
+#endif
+
+#ifdef FINGERPRINT_CACHE
+static fp_cache_t fingerprintCache;
+#endif
+
+#ifdef SCHEDULE_LEARNER
+static r_schedule_t schedule;
+#endif
+
+#ifdef NOISE_FILTER
+static noise_filter_t noiseFilter = {NOISE_FILTER_LEVEL, NOISE_FILTER_SAMPLE};
+#endif
+
+#ifdef PULSE_SEPARATION
+static pulse_separator_t separator = {PULSE_SEPARATION_DB};
+#endif
+
+#ifdef DECODER_PROFILE
+static unsigned profileBase; // decoder task stack used above the decoding
+#endif
+
+#ifdef FLEX_ANALYZER
+static flex_analyzer_t flexAnalyzer;
+static SemaphoreHandle_t flexAnalyzerMutex; // started and stopped from the caller task
+#endif
+
 r_cfg_t g_cfg; // Global config object
 
+// held by the decoder task while it decodes and outputs, filters are changed
+// and status messages are output from the caller task
+static SemaphoreHandle_t filterMutex;
+
 TaskHandle_t rtl_433_DecoderHandle;
 static QueueHandle_t rtl_433_Queue;
 
@@ -68,6 +101,9 @@ void rtlSetup() {
                 ESP.getFreeHeap());
 #endif
     cfg->conversion_mode = CONVERT_SI; // Default all output to Celsius
+#ifdef SCHEDULE_LEARNER
+    cfg->schedule = &schedule;
+#endif
     if (rtl_433_ESP::ookModulation) {
       cfg->num_r_devices = NUMOF_OOK_DEVICES;
     } else {
@@ -433,11 +469,18 @@ void rtlSetup() {
       }
 #endif
     }
+    // apply protocol filters set before the decoders were registered
+    r_filter_update(cfg);
 
 #ifdef MEMORY_DEBUG
     logprintfLn(LOG_DEBUG, "Pre xQueueCreate heap %d", ESP.getFreeHeap());
 #endif
     rtl_433_Queue = xQueueCreate(5, sizeof(pulse_data_t*));
+    // recursive, a message callback in the decoder task may change the filters
+    filterMutex = xSemaphoreCreateRecursiveMutex();
+#ifdef FLEX_ANALYZER
+    flexAnalyzerMutex = xSemaphoreCreateMutex();
+#endif
 
 #ifdef MEMORY_DEBUG
     logprintfLn(LOG_DEBUG, "Pre xTaskCreatePinnedToCore heap %d",
@@ -464,22 +507,306 @@ void _setCallback(rtl_433_ESPCallBack callback, char* messageBuffer,
 
   r_cfg_t* cfg = &g_cfg;
   cfg->callback = callback;
+  cfg->typed_callback = NULL;
   cfg->messageBuffer = messageBuffer;
   cfg->bufferSize = bufferSize;
 }
 
+void _setTypedCallback(rtl_433_ESPTypedCallBack callback, uint8_t* messageBuffer,
+                       int bufferSize, int encoding) {
+  r_cfg_t* cfg = &g_cfg;
+  cfg->callback = NULL;
+  cfg->typed_callback = callback;
+  cfg->encoding = encoding == RTL_433_JSON ? R_ENCODING_JSON : R_ENCODING_CBOR;
+  cfg->messageBuffer = (char*)messageBuffer;
+  cfg->bufferSize = bufferSize;
+}
+
+static void lockFilters() {
+  if (filterMutex) // else the decoder task is not started
+    xSemaphoreTakeRecursive(filterMutex, portMAX_DELAY);
+}
+
+static void unlockFilters() {
+  if (filterMutex)
+    xSemaphoreGiveRecursive(filterMutex);
+}
+
+// messageBuffer is shared with the decoder task, which outputs holding the lock
+void _outputMessage(data_t* data) {
+  lockFilters();
+  r_output_message(&g_cfg, data);
+  unlockFilters();
+}
+
 void _setDebug(int debug) {
   rtlVerbose = debug;
   logprintfLn(LOG_INFO, "Setting rtl_433 debug to: %d", rtlVerbose);
 }
 
+bool _addFilter(const char* rule) {
+  lockFilters();
+  int err = r_filter_add(&g_cfg, rule);
+  unlockFilters();
+  if (err) {
+    logprintfLn(LOG_ERR, "Invalid message filter: %s", rule);
+    return false;
+  }
+  logprintfLn(LOG_INFO, "Adding message filter: %s", rule);
+  return true;
+}
+
+void _setFilterMinRssi(int minRssi) {
+  lockFilters();
+  r_filter_set_min_rssi(&g_cfg, minRssi);
+  unlockFilters();
+  logprintfLn(LOG_INFO, "Setting message filter minimum RSSI to: %d", minRssi);
+}
+
+void _clearFilters() {
+  lockFilters();
+  r_filter_clear(&g_cfg);
+  unlockFilters();
+}
+
+r_filter_t* _getFilter() {
+  return g_cfg.filter;
+}
+
+fp_cache_t* _getFingerprintCache() {
+#ifdef FINGERPRINT_CACHE
+  return &fingerprintCache;
+#else
+  return NULL;
+#endif
+}
+
+r_schedule_t* _getSchedule() {
+#ifdef SCHEDULE_LEARNER
+  return &schedule;
+#else
+  return NULL;
+#endif
+}
+
+void _outputSchedule() {
+#ifdef SCHEDULE_LEARNER
+  // a copy, the decoder task keeps learning
+  r_schedule_t* copy = (r_schedule_t*)malloc(sizeof(r_schedule_t));
+  if (!copy)
+    return;
+  memcpy(copy, &schedule, sizeof(r_schedule_t));
+  uint32_t now = millis();
+  for (unsigned i = 0; i < SCHEDULE_SIZE; ++i) {
+    copy->entries[i].id[SCHEDULE_ID_LEN - 1] = '\0';
+    data_t* data = r_schedule_data(copy, i, now);
+    if (data) {
+      _outputMessage(data);
+      data_free(data);
+    }
+  }
+  free(copy);
+#endif
+}
+
+void _setNoiseFilter(int level, int sampleEvery) {
+#ifdef NOISE_FILTER
+  noiseFilter.level = level;
+  noiseFilter.sample_every = sampleEvery > 0 ? sampleEvery : 0;
+  logprintfLn(LOG_INFO, "Setting noise filter level to: %d, sample every: %d", level, sampleEvery);
+#endif
+}
+
+noise_filter_t* _getNoiseFilter() {
+#ifdef NOISE_FILTER
+  return &noiseFilter;
+#else
+  return NULL;
+#endif
+}
+
+pulse_separator_t* _getSeparator() {
+#ifdef PULSE_SEPARATION
+  return &separator;
+#else
+  return NULL;
+#endif
+}
+
+unsigned _recommendedDecoderStack() {
+#ifdef DECODER_PROFILE
+  if (!g_cfg.demod) // before rtlSetup()
+    return 0;
+  unsigned depth = 0;
+  list_t* r_devs = &g_cfg.demod->r_devs;
+  for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+    r_device* r_dev = (r_device*)*iter;
+    if (r_filter_decoder_enabled(g_cfg.filter, r_dev->protocol_num) && r_dev->profile_stack > depth)
+      depth = r_dev->profile_stack;
+  }
+  return profileBase && depth ? stack_profile_recommend(profileBase, depth, 1.0f, DECODER_PROFILE_RESERVE) : 0;
+#else
+  return 0;
+#endif
+}
+
+void _printDecoderProfile() {
+#ifdef DECODER_PROFILE
+  logprintfLn(LOG_INFO, "Decoder stack profile, task base: %u bytes", profileBase);
+  list_t* r_devs = &g_cfg.demod->r_devs;
+  for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+    r_device* r_dev = (r_device*)*iter;
+    if (r_dev->profile_stack)
+      logprintfLn(LOG_INFO, "%3u %-5u %s", r_dev->protocol_num, r_dev->profile_stack, r_dev->name);
+  }
+  logprintfLn(LOG_INFO, "rtl_433_Decoder_Stack: %d, recommended for the enabled decoders: %u",
+              rtl_433_Decoder_Stack, _recommendedDecoderStack());
+#endif
+}
+
+#ifdef RTL_TRACE
+/// Trace dump as hex lines in the log, 32 bytes per line.
+typedef struct trace_hex {
+  unsigned fill;
+  uint8_t buf[32];
+} trace_hex_t;
+
+static void traceHexFlush(trace_hex_t* hex) {
+  if (!hex->fill)
+    return;
+  logprintf(LOG_INFO, "TRACE ");
+  for (unsigned i = 0; i < hex->fill; ++i)
+    alogprintf(LOG_INFO, "%02x", hex->buf[i]);
+  alogprintfLn(LOG_INFO, " ");
+  hex->fill = 0;
+}
+
+static size_t traceHexWrite(void const* buf, size_t len, void* ctx) {
+  trace_hex_t* hex = (trace_hex_t*)ctx;
+  uint8_t const* p = (uint8_t const*)buf;
+  for (size_t i = 0; i < len; ++i) {
+    hex->buf[hex->fill++] = p[i];
+    if (hex->fill == sizeof(hex->buf))
+      traceHexFlush(hex);
+  }
+  return len;
+}
+#endif
+
+void _dumpTrace() {
+#ifdef RTL_TRACE
+  trace_hex_t hex = {0};
+  logprintfLn(LOG_INFO, "TRACE BEGIN");
+  trace_dump(traceHexWrite, &hex);
+  traceHexFlush(&hex);
+  logprintfLn(LOG_INFO, "TRACE END");
+#endif
+}
+
+void _startFlexAnalyzer(int trains, int minPulses) {
+#ifdef FLEX_ANALYZER
+  if (!flexAnalyzerMutex)
+    return;
+  xSemaphoreTake(flexAnalyzerMutex, portMAX_DELAY);
+  flex_analyzer_start(&flexAnalyzer, trains > 0 ? trains : 1, minPulses > 0 ? minPulses : 0,
+                      !rtl_433_ESP::ookModulation);
+  xSemaphoreGive(flexAnalyzerMutex);
+  logprintfLn(LOG_INFO, "Starting flex analyzer, trains: %d, min pulses: %d", trains, minPulses);
+#endif
+}
+
+void _stopFlexAnalyzer() {
+#ifdef FLEX_ANALYZER
+  if (!flexAnalyzerMutex)
+    return;
+  data_t* data = NULL;
+  xSemaphoreTake(flexAnalyzerMutex, portMAX_DELAY);
+  if (flexAnalyzer.active)
+    data = flex_analyzer_report(&flexAnalyzer, NULL);
+  xSemaphoreGive(flexAnalyzerMutex);
+  if (data) {
+    _outputMessage(data);
+    data_free(data);
+  }
+#endif
+}
+
+unsigned _maxResetLimit(unsigned below) {
+  if (!g_cfg.demod) // before rtlSetup()
+    return 0;
+  list_t* r_devs = &g_cfg.demod->r_devs;
+  float resetLimit = 0;
+  for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+    r_device* r_dev = (r_device*)*iter;
+    if (below && r_dev->reset_limit >= below)
+      continue;
+    if (r_filter_decoder_enabled(g_cfg.filter, r_dev->protocol_num) && r_dev->reset_limit > resetLimit)
+      resetLimit = r_dev->reset_limit;
+  }
+  return (unsigned)resetLimit;
+}
+
+unsigned _minSignalLength() {
+  if (!g_cfg.demod) // before rtlSetup()
+    return 0;
+  list_t* r_devs = &g_cfg.demod->r_devs;
+  float minLength = 0;
+  for (void** iter = r_devs->elems; iter && *iter; ++iter) {
+    r_device* r_dev = (r_device*)*iter;
+    // shortest train a decoder can accept, PD_MIN_PULSES of its shortest symbol
+    float length = r_dev->short_width * PD_MIN_PULSES;
+    if (r_filter_decoder_enabled(g_cfg.filter, r_dev->protocol_num) && length > 0 && (minLength == 0 || length < minLength))
+      minLength = length;
+  }
+  return (unsigned)minLength;
+}
+
 // ---------------------------------------------------------------------------------------------------------
 
+#ifdef PULSE_SEPARATION
+/**
+ * Decode the trains of two transmitters received at once, see pulse_separate.h
+ */
+static int separateSignal(pulse_data_t* rtl_pulses) {
+  uint8_t* level = (uint8_t*)malloc(rtl_pulses->num_pulses);
+  if (!level)
+    return 0;
+  int events = 0;
+  if (pulse_separate(&separator, rtl_pulses, level)) {
+    pulse_data_t* part = (pulse_data_t*)malloc(sizeof(pulse_data_t));
+    if (part) {
+      // the stronger transmitter first
+      for (int which = 1; which >= 0; --which) {
+        pulse_separate_train(rtl_pulses, level, which, part);
+#  ifdef PULSE_CLASSES
+        pulse_classes_build(&pulseClasses, part);
+#  endif
+        g_cfg.demod->pulse_data = *part; // messages report the rssi and duration of their part
+        events += run_ook_demods(&g_cfg.demod->r_devs, part);
+      }
+      g_cfg.demod->pulse_data = *rtl_pulses;
+      free(part);
+    } else {
+      logprintfLn(LOG_ERR, "ERROR: no memory to separate a signal");
+    }
+    if (events > 0)
+      separator.decoded++;
+#  ifdef PULSE_CLASSES
+    if (events == 0)
+      pulse_classes_build(&pulseClasses, rtl_pulses); // the unparsed train is analyzed next
+#  endif
+  }
+  free(level);
+  return events;
+}
+#endif
+
 void rtl_433_DecoderTask(void* pvParameters) {
   pulse_data_t* rtl_pulses = nullptr;
   for (;;) {
     // logprintfLn(LOG_DEBUG, "rtl_433_DecoderTask awaiting signal");
     xQueueReceive(rtl_433_Queue, &rtl_pulses, portMAX_DELAY);
+    TRACE(TRACE_DECODE_BEGIN, rtl_pulses->num_pulses);
     // logprintfLn(LOG_DEBUG, "rtl_433_DecoderTask signal received");
 #ifdef MEMORY_DEBUG
     unsigned long signalProcessingStart = micros();
@@ -491,7 +818,8 @@ void rtl_433_DecoderTask(void* pvParameters) {
       alogprintf(LOG_INFO, "+%d", rtl_pulses->pulse[i]);
       alogprintf(LOG_INFO, "-%d", rtl_pulses->gap[i]);
 #  ifdef SIGNAL_RSSI
-      alogprintf(LOG_INFO, "(%d)", rtl_pulses->rssi[i]);
+      if (rtl_pulses->rssi[i] != RSSI_RING_NONE)
+        alogprintf(LOG_INFO, "(%d)", rtl_pulses->rssi[i]);
 #  endif
     }
     alogprintfLn(LOG_INFO, " ");
@@ -500,15 +828,51 @@ void rtl_433_DecoderTask(void* pvParameters) {
     logprintfLn(LOG_INFO, "Pre run_%s_demods: %d", rtl_433_ESP::ookModulation ? "OOK" : "FSK", ESP.getFreeHeap());
 #endif
     rtl_pulses->sample_rate = 1.0e6;
+    lockFilters();
     r_cfg_t* cfg = &g_cfg;
     cfg->demod->pulse_data = *rtl_pulses;
     int events = 0;
+#ifdef PULSE_CLASSES
+    pulse_classes_build(&pulseClasses, rtl_pulses);
+#endif
+#ifdef DECODER_PROFILE
+    uint8_t marker;
+    unsigned base = pxTaskGetStackStart(NULL) + rtl_433_Decoder_Stack - &marker;
+    if (base > profileBase)
+      profileBase = base;
+    cfg->profile_top = &marker;
+#endif
 
-    if (rtl_433_ESP::ookModulation) {
-      events = run_ook_demods(&cfg->demod->r_devs, rtl_pulses);
-    } else {
-      events = run_fsk_demods(&cfg->demod->r_devs, rtl_pulses);
+#ifdef SCHEDULE_LEARNER
+    // devices expected now first
+    events = r_schedule_demod(&schedule, rtl_pulses, !rtl_433_ESP::ookModulation, millis());
+    if (events == 0) {
+#endif
+#ifdef FINGERPRINT_CACHE
+      events = fp_cache_demod(&fingerprintCache, &cfg->demod->r_devs, rtl_pulses, !rtl_433_ESP::ookModulation);
+#else
+      if (rtl_433_ESP::ookModulation) {
+        events = run_ook_demods(&cfg->demod->r_devs, rtl_pulses);
+      } else {
+        events = run_fsk_demods(&cfg->demod->r_devs, rtl_pulses);
+      }
+#endif
+#ifdef SCHEDULE_LEARNER
     }
+    r_schedule_end(&schedule);
+#endif
+#ifdef PULSE_SEPARATION
+    if (events == 0 && rtl_433_ESP::ookModulation)
+      events = separateSignal(rtl_pulses);
+#endif
+    rtl_433_ESP::decodedMessages += events;
+    TRACE(TRACE_DECODE_END, events);
+#ifdef NOISE_FILTER
+    if (rtl_pulses->noiseSample && events > 0) {
+      noiseFilter.missed++;
+      logprintfLn(LOG_INFO, "Noise filter dropped a decodable signal, score %d", noise_score(rtl_pulses));
+    }
+#endif
     if (events == 0) {
 #ifdef RTL_ANALYZER
       pulse_analyzer(rtl_pulses, rtl_433_ESP::ookModulation ? 1 : 2);
@@ -522,16 +886,24 @@ void rtl_433_DecoderTask(void* pvParameters) {
       //      alogprintf(LOG_INFO, ", messageCount: %d", messageCount);
       alogprintfLn(LOG_INFO, ", pulses: %d", rtl_pulses->num_pulses);
 
-      logprintf(LOG_INFO, "RAW (%lu): ", rtl_pulses->signalDuration);
+      // the bucket form instead of +p-g, smaller and read by rtl_433 -y, pdv and the RF Bridge,
+      // RAW_SIGNAL_DEBUG logs the exact widths
+      int rfrawLength = rfraw_encode(rtl_pulses, NULL, 0);
+      char* rfraw = rfrawLength < g_cfg.bufferSize / 2 ? (char*)malloc(rfrawLength + 1) : NULL;
+      if (rfraw) {
+        rfraw_encode(rtl_pulses, rfraw, rfrawLength + 1);
+        logprintfLn(LOG_INFO, "RFRAW (%lu): %s", rtl_pulses->signalDuration, rfraw);
+      }
 #  ifndef RAW_SIGNAL_DEBUG
-      for (int i = 0; i < rtl_pulses->num_pulses; i++) {
-        alogprintf(LOG_INFO, "+%d", rtl_pulses->pulse[i]);
-        alogprintf(LOG_INFO, "-%d", rtl_pulses->gap[i]);
-#    ifdef SIGNAL_RSSI
-        alogprintf(LOG_INFO, "(%d)", rtl_pulses->rssi[i]);
-#    endif
+      else {
+        // too long to publish, log the exact widths instead
+        logprintf(LOG_INFO, "RAW (%lu): ", rtl_pulses->signalDuration);
+        for (int i = 0; i < rtl_pulses->num_pulses; i++) {
+          alogprintf(LOG_INFO, "+%d", rtl_pulses->pulse[i]);
+          alogprintf(LOG_INFO, "-%d", rtl_pulses->gap[i]);
+        }
+        alogprintfLn(LOG_INFO, " ");
       }
-      alogprintfLn(LOG_INFO, " ");
 #  endif
 
       // Send a note saying unparsed signal signal received
@@ -543,6 +915,8 @@ void rtl_433_DecoderTask(void* pvParameters) {
                 "duration", "",   DATA_INT,     rtl_pulses->signalDuration,
                 "rssi", "", DATA_INT,     rtl_pulses->signalRssi,
                 "pulses", "",     DATA_INT,     rtl_pulses->num_pulses,
+                "noiseSample", "", DATA_COND, rtl_pulses->noiseSample, DATA_INT, 1,
+                "rfraw", "",      DATA_COND, rfraw != NULL, DATA_STRING, rfraw ? rfraw : "",
 //                "train", "",      DATA_INT,     _actualPulseTrain,
 //                "messageCount", "", DATA_INT,   messageCount,
 //                "_enabledReceiver", "", DATA_INT, _enabledReceiver,
@@ -552,13 +926,24 @@ void rtl_433_DecoderTask(void* pvParameters) {
                 NULL);
       /* clang-format on */
 
-      r_cfg_t* cfg = &g_cfg;
-      data_print_jsons(data, cfg->messageBuffer, cfg->bufferSize);
-      (cfg->callback)(cfg->messageBuffer);
+      r_output_message(&g_cfg, data);
       data_free(data);
+      free(rfraw);
 
+#endif
+#ifdef FLEX_ANALYZER
+      data_t* report = NULL;
+      xSemaphoreTake(flexAnalyzerMutex, portMAX_DELAY);
+      if (flex_analyzer_add(&flexAnalyzer, rtl_pulses))
+        report = flex_analyzer_report(&flexAnalyzer, rtl_pulses); // slices this train with the guess
+      xSemaphoreGive(flexAnalyzerMutex);
+      if (report) {
+        r_output_message(&g_cfg, report);
+        data_free(report);
+      }
 #endif
     }
+    unlockFilters();
 
 #ifdef MEMORY_DEBUG
     logprintfLn(LOG_INFO, "Signal processing time: %lu",
@@ -592,13 +977,36 @@ void rtl_433_DecoderTask(void* pvParameters) {
   }
 }
 
-void processSignal(pulse_data_t* rtl_pulses) {
+int processSignal(pulse_data_t* rtl_pulses, TickType_t wait) {
   // logprintfLn(LOG_DEBUG, "processSignal() about to place signal on
   // rtl_433_Queue");
-  if (xQueueSend(rtl_433_Queue, &rtl_pulses, 0) != pdTRUE) {
+  if (!rtl_433_Queue) {
+    free(rtl_pulses); // the decoder is not set up
+    return -1;
+  }
+  if (!r_filter_signal(&g_cfg, rtl_pulses->signalRssi)) {
+    TRACE(TRACE_TRAIN_DROPPED, TRACE_DROP_RSSI);
+    free(rtl_pulses);
+    return -1;
+  }
+#ifdef NOISE_FILTER
+  // counted as unparsed, as the decoders would have found nothing
+  int pass = noise_filter_train(&noiseFilter, rtl_pulses);
+  if (!pass) {
+    TRACE(TRACE_TRAIN_DROPPED, TRACE_DROP_NOISE);
+    rtl_433_ESP::unparsedSignals++;
+    free(rtl_pulses);
+    return -1;
+  }
+  rtl_pulses->noiseSample = pass == 2;
+#endif
+  if (xQueueSend(rtl_433_Queue, &rtl_pulses, wait) != pdTRUE) {
+    TRACE(TRACE_TRAIN_DROPPED, TRACE_DROP_QUEUE);
     logprintfLn(LOG_ERR, "ERROR: rtl_433_Queue full, discarding signal");
     free(rtl_pulses);
-  } else {
-    // logprintfLn(LOG_DEBUG, "processSignal() signal placed on rtl_433_Queue");
+    return -1;
   }
+  TRACE(TRACE_TRAIN_QUEUED, uxQueueMessagesWaiting(rtl_433_Queue));
+  // logprintfLn(LOG_DEBUG, "processSignal() signal placed on rtl_433_Queue");
+  return 0;
 }
@@ -29,15 +29,29 @@
 #include "rtl_433_ESP.h"
 
 extern "C" {
+#include "autotune.h"
 #include "bitbuffer.h"
+#include "bitbuffer_index.h"
 #include "fatal.h"
+#include "flex_analyzer.h"
 #include "list.h"
+#include "noise_filter.h"
 #include "pulse_analyzer.h"
+#include "pulse_classes.h"
 #include "pulse_detect.h"
+#include "pulse_inject.h"
+#include "pulse_separate.h"
 #include "r_api.h"
+#include "r_filter.h"
+#include "r_fingerprint.h"
 #include "r_private.h"
+#include "r_schedule.h"
+#include "rfraw.h"
+#include "rssi_ring.h"
 #include "rtl_433.h"
 #include "rtl_433_devices.h"
+#include "stack_profile.h"
+#include "trace.h"
 }
 
 #include "log.h"
@@ -48,8 +62,30 @@ extern "C" {
 void rtlSetup();
 void _setCallback(rtl_433_ESPCallBack callback, char* messageBuffer,
                   int bufferSize);
+void _setTypedCallback(rtl_433_ESPTypedCallBack callback, uint8_t* messageBuffer,
+                       int bufferSize, int encoding);
+void _outputMessage(data_t* data);
 void _setDebug(int debug);
-void processSignal(pulse_data_t* rtl_pulses);
+bool _addFilter(const char* rule);
+void _setFilterMinRssi(int minRssi);
+void _clearFilters();
+r_filter_t* _getFilter();
+fp_cache_t* _getFingerprintCache();
+r_schedule_t* _getSchedule();
+void _outputSchedule();
+void _setNoiseFilter(int level, int sampleEvery);
+noise_filter_t* _getNoiseFilter();
+pulse_separator_t* _getSeparator();
+unsigned _recommendedDecoderStack();
+void _printDecoderProfile();
+void _dumpTrace();
+void _startFlexAnalyzer(int trains, int minPulses);
+void _stopFlexAnalyzer();
+/// Largest reset_limit of the enabled decoders below `below`, 0 for any.
+unsigned _maxResetLimit(unsigned below = 0);
+unsigned _minSignalLength();
+/// Queue a train for decoding, takes ownership, returns 0 if queued.
+int processSignal(pulse_data_t* rtl_pulses, TickType_t wait = 0);
 void rtl_433_DecoderTask(void* pvParameters);
 extern TaskHandle_t rtl_433_DecoderHandle;
 
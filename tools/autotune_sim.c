@@ -0,0 +1,144 @@
+/** @file
+    Run the receiver autotuner against a simulated radio.
+
+    Build on the host:
+
+        cc -O2 -Iinclude -o autotune_sim tools/autotune_sim.c src/rtl_433/autotune.c -lm
+
+    Without arguments the radio is a synthetic response surface with noise.
+    With log files from the manual sweeps in OOK_Receiver.ino (lines like
+    "Finished setBitrate:   17.00, count: 12") the score of a configuration
+    is interpolated from the logged counts of each swept parameter, assuming
+    the parameters are independent.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "autotune.h"
+
+#define MAX_POINTS 1024
+
+typedef struct trace {
+  char const* name; ///< autotune parameter name
+  char const* test; ///< sweep name in the log
+  unsigned num_points;
+  float value[MAX_POINTS];
+  float count[MAX_POINTS];
+} trace_t;
+
+static trace_t traces[] = {
+    {.name = "bitRate", .test = "setBitrate"},
+    {.name = "freqDev", .test = "setFrequencyDeviation"},
+    {.name = "rxBandwidth", .test = "setRxBandwidth"},
+};
+#define NUM_TRACES (sizeof(traces) / sizeof(traces[0]))
+
+static void read_log(char const* path) {
+  FILE* fp = fopen(path, "r");
+  if (!fp) {
+    perror(path);
+    exit(1);
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), fp)) {
+    char const* p = strstr(line, "Finished ");
+    char test[64];
+    float value, count;
+    if (!p || sscanf(p, "Finished %63[^:]: %f, count: %f", test, &value, &count) != 3)
+      continue;
+    for (unsigned i = 0; i < NUM_TRACES; ++i) {
+      trace_t* t = &traces[i];
+      if (strcmp(t->test, test) || t->num_points >= MAX_POINTS)
+        continue;
+      t->value[t->num_points] = value;
+      t->count[t->num_points] = count;
+      t->num_points++;
+    }
+  }
+  fclose(fp);
+}
+
+/// Average count of the logged points closest to value.
+static float trace_score(trace_t const* t, float value) {
+  float best_dist = INFINITY;
+  float sum = 0;
+  unsigned n = 0;
+  for (unsigned i = 0; i < t->num_points; ++i) {
+    float dist = fabsf(t->value[i] - value);
+    if (dist < best_dist) {
+      best_dist = dist;
+      sum = 0;
+      n = 0;
+    }
+    if (dist == best_dist) {
+      sum += t->count[i];
+      n++;
+    }
+  }
+  return n ? sum / n : 0;
+}
+
+static float score_trace(autotune_t* at, void* ctx) {
+  (void)ctx;
+  float score = 0;
+  unsigned n = 0;
+  for (unsigned i = 0; i < NUM_TRACES; ++i) {
+    if (traces[i].num_points) {
+      score += trace_score(&traces[i], autotune_value(at, traces[i].name, 0));
+      n++;
+    }
+  }
+  return n ? score / n : 0;
+}
+
+/// Synthetic radio, the message rate peaks at a site specific setting.
+static float score_synthetic(autotune_t* at, void* ctx) {
+  (void)ctx;
+  static float const optimum[][2] = {
+      // optimum, width
+      {17.24f, 20.0f},  // bitRate
+      {55.0f, 60.0f},   // freqDev
+      {330.0f, 150.0f}, // rxBandwidth
+      {11.0f, 8.0f},    // ookThreshold
+      {7.0f, 6.0f},     // rssiDelta
+  };
+  static char const* const names[] = {"bitRate", "freqDev", "rxBandwidth", "ookThreshold", "rssiDelta"};
+  float rate = 30.0f; // messages per minute at the optimum
+  for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    float d = (autotune_value(at, names[i], optimum[i][0]) - optimum[i][0]) / optimum[i][1];
+    rate *= expf(-d * d);
+  }
+  // counting noise of a two minute trial
+  float noise = ((float)rand() / RAND_MAX - 0.5f) * 2.0f * sqrtf(rate / 2 + 1);
+  return rate + noise;
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i)
+    read_log(argv[i]);
+
+  autotune_t at = {0};
+  autotune_add_param(&at, "bitRate", 1.0f, 300.0f, 16.0f, 0.5f, 1.2f);
+  autotune_add_param(&at, "freqDev", 5.0f, 200.0f, 16.0f, 1.0f, 40.0f);
+  autotune_add_param(&at, "rxBandwidth", 58.0f, 812.0f, 64.0f, 8.0f, 250.0f);
+  if (argc < 2) {
+    autotune_add_param(&at, "ookThreshold", 1.0f, 60.0f, 4.0f, 1.0f, 15.0f);
+    autotune_add_param(&at, "rssiDelta", 2.0f, 20.0f, 2.0f, 1.0f, 9.0f);
+  }
+  autotune_init(&at, 1.0f, 200);
+
+  unsigned trials = autotune_run(&at, argc < 2 ? score_synthetic : score_trace, NULL);
+
+  printf("%u trials, best score %.1f\n", trials, at.best_score);
+  for (unsigned i = 0; i < at.num_params; ++i)
+    printf("  %-12s %8.2f\n", at.params[i].name, at.params[i].value);
+  return 0;
+}
@@ -0,0 +1,458 @@
+/** @file
+    Decode pulse captures on all cores.
+
+    Build on the host:
+
+        cc -O2 -DNDEBUG -Iinclude -ffunction-sections -fdata-sections \
+            -o batch_decode tools/batch_decode.c src/rtl_433/[a-z]*.c src/rtl_433/devices/[a-z]*.c \
+            -Wl,--gc-sections -lpthread -lm
+
+    Usage:
+
+        batch_decode [-j THREADS] [-m ook|fsk] [-n LEVEL] [-o OUT.ndjson] IN.rcap|IN.txt...
+
+    Every thread has its own decoder configuration with all OOK and all
+    FSK decoders registered, the trains of all captures are handed out
+    in chunks.  Each decoded message is written as one JSON line with
+    the capture file and the train number prepended, lines of different
+    chunks are not in capture order.  Trains are decoded as recorded in
+    the capture unless -m selects the modulation.  Throughput and the
+    messages per protocol are printed to stderr.
+
+    Inputs that are not a capture are read as text with the trains in
+    the forms rtl_433_ESP::injectPulseText() accepts, OOK text, RfRaw and
+    "+pulse-gap" lines, see pulse_inject.h.
+
+    -n scores every train with the noise filter at LEVEL, the trains it
+    rejects are decoded anyway and counted, decoded rejects are signals
+    the filter would have dropped on the device.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "c_util.h"
+#include "noise_filter.h"
+#include "pulse_capture.h"
+#include "pulse_data.h"
+#include "pulse_inject.h"
+#include "r_api.h"
+#include "r_device.h"
+#include "r_private.h"
+#include "rtl_433.h"
+#include "rtl_433_devices.h"
+
+#define CHUNK_TRAINS 256
+#define MESSAGE_SIZE 4096
+#define OUTPUT_FLUSH 65536
+
+static r_device* const devices[] = {
+#define DECL(name) &name,
+    DEVICES
+#undef DECL
+};
+#define NUM_DEVICES (sizeof(devices) / sizeof(*devices))
+
+typedef struct capture {
+  char const* path;
+  char* json_path; ///< path as JSON string
+  void* map;
+  size_t len;
+  int packed; ///< map is a capture packed from text
+  pulse_capture_reader_t reader;
+  unsigned first; ///< number of the first train over all captures
+} capture_t;
+
+typedef struct worker {
+  pthread_t thread;
+  r_cfg_t ook;
+  r_cfg_t fsk;
+  char message[MESSAGE_SIZE];
+  char* out;
+  size_t out_len;
+  size_t out_size;
+  capture_t const* capture; ///< train being decoded, for the message callback
+  unsigned train;
+  unsigned long trains;
+  unsigned long pulses;
+  unsigned long messages;
+  unsigned long corrupt;
+  noise_filter_t noise;
+} worker_t;
+
+static capture_t* captures;
+static unsigned num_captures;
+static unsigned total_trains;
+static atomic_uint next_train;
+static int modulation = -1; ///< -1 as recorded, 0 OOK, 1 FSK
+static int noise_level;
+static FILE* output;
+static pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/// The worker of this thread, the message callback has no context.
+static R_THREAD_LOCAL worker_t* current;
+
+static void out_append(worker_t* w, char const* buf, size_t len) {
+  if (w->out_len + len > w->out_size) {
+    size_t size = MAX(w->out_size * 2, w->out_len + len + OUTPUT_FLUSH);
+    char* out = realloc(w->out, size);
+    if (!out) {
+      fprintf(stderr, "out of memory\n");
+      exit(1);
+    }
+    w->out = out;
+    w->out_size = size;
+  }
+  memcpy(w->out + w->out_len, buf, len);
+  w->out_len += len;
+}
+
+static void out_flush(worker_t* w) {
+  if (!w->out_len)
+    return;
+  pthread_mutex_lock(&output_lock);
+  fwrite(w->out, 1, w->out_len, output);
+  pthread_mutex_unlock(&output_lock);
+  w->out_len = 0;
+}
+
+static void message_callback(char* message) {
+  worker_t* w = current;
+  char prefix[64];
+  w->messages++;
+  out_append(w, "{\"file\":", 8);
+  out_append(w, w->capture->json_path, strlen(w->capture->json_path));
+  int len = snprintf(prefix, sizeof(prefix), ",\"train\":%u", w->train);
+  out_append(w, prefix, len);
+  if (*message == '{')
+    message++;
+  if (*message && *message != '}')
+    out_append(w, ",", 1);
+  out_append(w, message, strlen(message));
+  out_append(w, "\n", 1);
+}
+
+static void worker_register(worker_t* w, r_cfg_t* cfg, int fsk) {
+  r_init_cfg(cfg);
+  cfg->conversion_mode = CONVERT_SI; // as on the device
+  cfg->callback = message_callback;
+  cfg->messageBuffer = w->message;
+  cfg->bufferSize = sizeof(w->message);
+  for (unsigned i = 0; i < NUM_DEVICES; ++i) {
+    if (devices[i]->disabled > 0 || (devices[i]->modulation >= FSK_DEMOD_MIN_VAL) != fsk)
+      continue;
+    register_protocol(cfg, devices[i], NULL);
+    // the protocol number is the position in DEVICES, also for created decoders
+    r_device* r_dev = cfg->demod->r_devs.elems[cfg->demod->r_devs.len - 1];
+    r_dev->protocol_num = i;
+  }
+}
+
+static capture_t const* find_capture(unsigned train) {
+  unsigned lo = 0;
+  unsigned hi = num_captures;
+  while (hi - lo > 1) {
+    unsigned mid = (lo + hi) / 2;
+    if (captures[mid].first <= train)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return &captures[lo];
+}
+
+static void decode_train(worker_t* w, capture_t const* capture, unsigned n) {
+  int fsk = modulation;
+  if (fsk < 0) {
+    // peek at the recorded modulation, the train is read into its config
+    if (pulse_capture_read(&capture->reader, n, &w->ook.demod->pulse_data)) {
+      w->corrupt++;
+      return;
+    }
+    fsk = w->ook.demod->pulse_data.fsk_f2_est != 0;
+    if (fsk)
+      w->fsk.demod->pulse_data = w->ook.demod->pulse_data;
+  } else if (pulse_capture_read(&capture->reader, n, &(fsk ? &w->fsk : &w->ook)->demod->pulse_data)) {
+    w->corrupt++;
+    return;
+  }
+
+  r_cfg_t* cfg = fsk ? &w->fsk : &w->ook;
+  pulse_data_t* pulses = &cfg->demod->pulse_data;
+  w->capture = capture;
+  w->train = n;
+  w->trains++;
+  w->pulses += pulses->num_pulses;
+  int rejected = !noise_filter_train(&w->noise, pulses);
+  int events = fsk ? run_fsk_demods(&cfg->demod->r_devs, pulses) : run_ook_demods(&cfg->demod->r_devs, pulses);
+  if (rejected && events > 0)
+    w->noise.missed++;
+}
+
+static void* worker_run(void* arg) {
+  worker_t* w = arg;
+  current = w;
+  for (;;) {
+    unsigned start = atomic_fetch_add(&next_train, CHUNK_TRAINS);
+    if (start >= total_trains)
+      break;
+    unsigned end = MIN(start + CHUNK_TRAINS, total_trains);
+    for (unsigned train = start; train < end; ++train) {
+      capture_t const* capture = find_capture(train);
+      decode_train(w, capture, train - capture->first);
+    }
+    if (w->out_len >= OUTPUT_FLUSH)
+      out_flush(w);
+  }
+  out_flush(w);
+  return NULL;
+}
+
+static char* json_string(char const* str) {
+  char* buf = malloc(2 * strlen(str) + 3);
+  if (!buf)
+    return NULL;
+  char* p = buf;
+  *p++ = '"';
+  for (; *str; ++str) {
+    if (*str == '"' || *str == '\\')
+      *p++ = '\\';
+    *p++ = *str;
+  }
+  *p++ = '"';
+  *p = '\0';
+  return buf;
+}
+
+typedef struct text_capture {
+  uint8_t* buf;
+  size_t len;
+  size_t size;
+} text_capture_t;
+
+static size_t text_capture_write(void const* buf, size_t len, void* ctx) {
+  text_capture_t* c = ctx;
+  if (c->len + len > c->size) {
+    size_t size = MAX(c->size * 2, c->len + len + 65536);
+    uint8_t* grown = realloc(c->buf, size);
+    if (!grown)
+      return 0;
+    c->buf = grown;
+    c->size = size;
+  }
+  memcpy(c->buf + c->len, buf, len);
+  c->len += len;
+  return len;
+}
+
+/// Pack the trains of a text into a capture in memory, replaces the map.
+static int pack_text(capture_t* capture) {
+  char* text = malloc(capture->len + 1);
+  pulse_data_t* pulses = malloc(sizeof(*pulses));
+  text_capture_t packed = {0};
+  pulse_capture_writer_t writer;
+  unsigned trains = 0;
+  int ret = -1;
+  if (!text || !pulses || pulse_capture_writer_init(&writer, text_capture_write, &packed))
+    goto out;
+  memcpy(text, capture->map, capture->len);
+  text[capture->len] = '\0';
+  for (char const* p = text; (p = pulse_inject_parse(pulses, p)); ++trains) {
+    pulse_inject_prepare(pulses);
+    if (pulse_capture_write(&writer, pulses))
+      goto out;
+  }
+  if (pulse_capture_writer_close(&writer) || !trains)
+    goto out;
+  ret = 0;
+out:
+  free(pulses);
+  free(text);
+  if (ret) {
+    free(packed.buf);
+    return ret;
+  }
+  munmap(capture->map, capture->len);
+  capture->map = packed.buf;
+  capture->len = packed.len;
+  capture->packed = 1;
+  return pulse_capture_reader_init(&capture->reader, capture->map, capture->len);
+}
+
+static int open_capture(capture_t* capture, char const* path) {
+  capture->path = path;
+  capture->json_path = json_string(path);
+  if (!capture->json_path)
+    return -1;
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st)) {
+    perror(path);
+    return -1;
+  }
+  capture->len = st.st_size;
+  capture->map = st.st_size ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close(fd);
+  if (capture->map == MAP_FAILED) {
+    perror(path);
+    return -1;
+  }
+  if (pulse_capture_reader_init(&capture->reader, capture->map, capture->len) && pack_text(capture)) {
+    fprintf(stderr, "%s: neither a pulse capture nor pulse text\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+typedef struct protocol_count {
+  unsigned protocol_num;
+  unsigned long events;
+  unsigned long ok;
+} protocol_count_t;
+
+static int count_cmp(void const* a, void const* b) {
+  protocol_count_t const* x = a;
+  protocol_count_t const* y = b;
+  if (x->ok != y->ok)
+    return x->ok < y->ok ? 1 : -1;
+  return (int)x->protocol_num - (int)y->protocol_num;
+}
+
+static void count_protocols(protocol_count_t* counts, r_cfg_t const* cfg) {
+  for (size_t i = 0; i < cfg->demod->r_devs.len; ++i) {
+    r_device const* r_dev = cfg->demod->r_devs.elems[i];
+    counts[r_dev->protocol_num].events += r_dev->decode_events;
+    counts[r_dev->protocol_num].ok += r_dev->decode_ok;
+  }
+}
+
+static void usage(char const* argv0) {
+  fprintf(stderr, "usage: %s [-j THREADS] [-m ook|fsk] [-n LEVEL] [-o OUT.ndjson] IN.rcap|IN.txt...\n", argv0);
+  exit(1);
+}
+
+int main(int argc, char** argv) {
+  long num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+  char const* out_path = NULL;
+  int opt;
+  while ((opt = getopt(argc, argv, "j:m:n:o:")) != -1) {
+    if (opt == 'j')
+      num_workers = atol(optarg);
+    else if (opt == 'm' && !strcmp(optarg, "ook"))
+      modulation = 0;
+    else if (opt == 'm' && !strcmp(optarg, "fsk"))
+      modulation = 1;
+    else if (opt == 'n')
+      noise_level = atoi(optarg);
+    else if (opt == 'o')
+      out_path = optarg;
+    else
+      usage(argv[0]);
+  }
+  if (optind >= argc || num_workers < 1)
+    usage(argv[0]);
+
+  output = out_path ? fopen(out_path, "w") : stdout;
+  if (!output) {
+    perror(out_path);
+    return 1;
+  }
+
+  num_captures = argc - optind;
+  captures = calloc(num_captures, sizeof(*captures));
+  if (!captures)
+    return 1;
+  for (unsigned i = 0; i < num_captures; ++i) {
+    if (open_capture(&captures[i], argv[optind + i]))
+      return 1;
+    captures[i].first = total_trains;
+    total_trains += captures[i].reader.num_trains;
+  }
+
+  worker_t* workers = calloc(num_workers, sizeof(*workers));
+  if (!workers)
+    return 1;
+  for (long i = 0; i < num_workers; ++i) {
+    worker_register(&workers[i], &workers[i].ook, 0);
+    worker_register(&workers[i], &workers[i].fsk, 1);
+    workers[i].noise.level = noise_level;
+  }
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (long i = 0; i < num_workers; ++i) {
+    if (pthread_create(&workers[i].thread, NULL, worker_run, &workers[i])) {
+      fprintf(stderr, "can't start thread %ld\n", i);
+      return 1;
+    }
+  }
+  for (long i = 0; i < num_workers; ++i)
+    pthread_join(workers[i].thread, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  if (fflush(output) || (out_path && fclose(output))) {
+    perror(out_path ? out_path : "stdout");
+    return 1;
+  }
+
+  unsigned long trains = 0, pulses = 0, messages = 0, corrupt = 0, rejected = 0, missed = 0;
+  protocol_count_t* counts = calloc(NUM_DEVICES, sizeof(*counts));
+  if (!counts)
+    return 1;
+  for (unsigned i = 0; i < NUM_DEVICES; ++i)
+    counts[i].protocol_num = i;
+  for (long i = 0; i < num_workers; ++i) {
+    trains += workers[i].trains;
+    pulses += workers[i].pulses;
+    messages += workers[i].messages;
+    corrupt += workers[i].corrupt;
+    rejected += workers[i].noise.rejected;
+    missed += workers[i].noise.missed;
+    count_protocols(counts, &workers[i].ook);
+    count_protocols(counts, &workers[i].fsk);
+  }
+
+  double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+  fprintf(stderr, "%u captures, %lu trains, %lu pulses, %lu corrupt, %lu messages\n", num_captures, trains, pulses,
+          corrupt, messages);
+  fprintf(stderr, "%.3f s on %ld threads, %.0f trains/s, %.0f pulses/s\n", seconds, num_workers,
+          seconds > 0 ? trains / seconds : 0.0, seconds > 0 ? pulses / seconds : 0.0);
+  if (noise_level)
+    fprintf(stderr, "noise filter level %d: %lu trains rejected, %lu of them decoded\n", noise_level, rejected, missed);
+
+  qsort(counts, NUM_DEVICES, sizeof(*counts), count_cmp);
+  fprintf(stderr, "%10s %10s  protocol\n", "ok", "events");
+  for (unsigned i = 0; i < NUM_DEVICES && counts[i].ok; ++i)
+    fprintf(stderr, "%10lu %10lu  [%u] %s\n", counts[i].ok, counts[i].events, counts[i].protocol_num,
+            devices[counts[i].protocol_num]->name);
+
+  for (unsigned i = 0; i < num_captures; ++i) {
+    pulse_capture_reader_free(&captures[i].reader);
+    if (captures[i].packed)
+      free(captures[i].map);
+    else
+      munmap(captures[i].map, captures[i].len);
+    free(captures[i].json_path);
+  }
+  for (long i = 0; i < num_workers; ++i) {
+    r_free_cfg(&workers[i].ook);
+    r_free_cfg(&workers[i].fsk);
+    free(workers[i].out);
+  }
+  free(workers);
+  free(counts);
+  free(captures);
+  return 0;
+}
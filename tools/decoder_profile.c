@@ -0,0 +1,357 @@
+/** @file
+    Profile the stack depth and heap use of each decoder on the host.
+
+    Build on the host:
+
+        cc -O2 -DNDEBUG -Iinclude -ffunction-sections -fdata-sections \
+            -o decoder_profile tools/decoder_profile.c src/rtl_433/[a-z]*.c src/rtl_433/devices/[a-z]*.c \
+            -Wl,--gc-sections,-z,now \
+            -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free,--wrap=strdup -lpthread -lm
+
+    Usage:
+
+        decoder_profile [-m ook|fsk] [-p NUM,...] [-s SCALE] [-r RESERVE] IN.rcap...
+
+    Each decoder is registered on its own and runs over all trains of its
+    modulation in the captures, or over all trains as -m selects, on a
+    thread with a painted stack.  The stack below the decoder loop is
+    repainted for every train, as DECODER_PROFILE does on the device, and
+    the allocations are counted by wrapping malloc() and friends, in
+    malloc_usable_size() units.  -z now binds the library calls at
+    startup, else the first decoder calling one pays for the lazy binding
+    on its stack.
+
+    The table lists the deepest stack use, the peak heap of one train and
+    the heap kept by the decoder setup, deepest first, decoders that are
+    disabled by default are marked with a "-".  The recommended
+    rtl_433_Decoder_Stack for the decoders selected with -p ( numbers of
+    the first column ), or all enabled decoders per modulation, is the
+    deepest use times SCALE ( default 1.25, Xtensa frames are larger than
+    x86-64 frames ) plus RESERVE bytes ( default 2048 ) for the decoder
+    task itself.  Compare with printDecoderProfile() on the device to
+    calibrate SCALE.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include <fcntl.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pulse_capture.h"
+#include "pulse_data.h"
+#include "r_api.h"
+#include "r_device.h"
+#include "r_private.h"
+#include "rtl_433.h"
+#include "rtl_433_devices.h"
+#include "stack_profile.h"
+
+#define THREAD_STACK (1024 * 1024)
+#define MESSAGE_SIZE 4096
+
+static r_device* const devices[] = {
+#define DECL(name) &name,
+    DEVICES
+#undef DECL
+};
+#define NUM_DEVICES (sizeof(devices) / sizeof(*devices))
+
+typedef struct profile {
+  unsigned num;      ///< position in DEVICES
+  int fsk;
+  int selected;
+  unsigned stack;    ///< deepest stack use of one train
+  long heap;         ///< peak heap of one train
+  long setup;        ///< heap kept by register_protocol()
+  unsigned trains;
+  unsigned messages;
+} profile_t;
+
+typedef struct capture {
+  void* map;
+  size_t len;
+  pulse_capture_reader_t reader;
+} capture_t;
+
+static capture_t* captures;
+static unsigned num_captures;
+static int modulation = -1; ///< -1 as recorded, 0 OOK, 1 FSK
+static char message[MESSAGE_SIZE];
+static unsigned messages;
+static uint8_t* thread_stack; ///< lowest address of the profile thread stack
+
+/* allocation hooks, only one decoder thread counts at a time */
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t nmemb, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+
+static int heap_counting;
+static long heap_current;
+static long heap_peak;
+
+static void heap_add(long size) {
+  heap_current += size;
+  if (heap_current > heap_peak)
+    heap_peak = heap_current;
+}
+
+void* __wrap_malloc(size_t size) {
+  void* p = __real_malloc(size);
+  if (p && heap_counting)
+    heap_add(malloc_usable_size(p));
+  return p;
+}
+
+void* __wrap_calloc(size_t nmemb, size_t size) {
+  void* p = __real_calloc(nmemb, size);
+  if (p && heap_counting)
+    heap_add(malloc_usable_size(p));
+  return p;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  long old = ptr && heap_counting ? (long)malloc_usable_size(ptr) : 0;
+  void* p = __real_realloc(ptr, size);
+  if (p && heap_counting)
+    heap_add((long)malloc_usable_size(p) - old);
+  return p;
+}
+
+void __wrap_free(void* ptr) {
+  if (ptr && heap_counting)
+    heap_current -= malloc_usable_size(ptr);
+  __real_free(ptr);
+}
+
+char* __wrap_strdup(char const* s) {
+  size_t len = strlen(s) + 1;
+  char* p = __wrap_malloc(len);
+  if (p)
+    memcpy(p, s, len);
+  return p;
+}
+
+/* profiling */
+
+static void message_callback(char* msg) {
+  (void)msg;
+  messages++;
+}
+
+static int train_fsk(pulse_data_t const* pulses) {
+  return modulation >= 0 ? modulation : pulses->fsk_f2_est != 0;
+}
+
+/// Decode all trains of the profiled modulation, on the painted thread stack.
+static void* profile_thread(void* arg) {
+  profile_t* profile = arg;
+  r_cfg_t cfg = {0};
+  r_init_cfg(&cfg);
+  cfg.conversion_mode = CONVERT_SI; // as on the device
+  cfg.callback = message_callback;
+  cfg.messageBuffer = message;
+  cfg.bufferSize = sizeof(message);
+
+  heap_current = heap_peak = 0;
+  heap_counting = 1;
+  register_protocol(&cfg, devices[profile->num], NULL);
+  heap_counting = 0;
+  profile->setup = heap_current;
+
+  uint8_t marker;
+  uint8_t* lo = thread_stack;
+  uint8_t* hi = (uint8_t*)((uintptr_t)&marker - STACK_PROFILE_GUARD);
+
+  pulse_data_t* pulses = &cfg.demod->pulse_data;
+  messages = 0;
+  for (unsigned c = 0; c < num_captures; ++c) {
+    for (unsigned n = 0; n < captures[c].reader.num_trains; ++n) {
+      if (pulse_capture_read(&captures[c].reader, n, pulses) || train_fsk(pulses) != profile->fsk)
+        continue;
+      profile->trains++;
+      stack_profile_paint(lo, hi);
+      heap_current = heap_peak = 0;
+      heap_counting = 1;
+      if (profile->fsk)
+        run_fsk_demods(&cfg.demod->r_devs, pulses);
+      else
+        run_ook_demods(&cfg.demod->r_devs, pulses);
+      heap_counting = 0;
+      unsigned depth = stack_profile_depth(lo, hi) + STACK_PROFILE_GUARD;
+      if (depth > profile->stack)
+        profile->stack = depth;
+      if (heap_peak > profile->heap)
+        profile->heap = heap_peak;
+    }
+  }
+  profile->messages = messages;
+  r_free_cfg(&cfg);
+  return NULL;
+}
+
+static void profile_decoder(profile_t* profile) {
+  pthread_attr_t attr;
+  pthread_t thread;
+  void* stack = aligned_alloc(4096, THREAD_STACK);
+  if (!stack) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  thread_stack = stack;
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, stack, THREAD_STACK);
+  if (pthread_create(&thread, &attr, profile_thread, profile)) {
+    fprintf(stderr, "can not create the profile thread\n");
+    exit(1);
+  }
+  pthread_join(thread, NULL);
+  pthread_attr_destroy(&attr);
+  free(stack);
+}
+
+static int cmp_stack(void const* a, void const* b) {
+  profile_t const* pa = a;
+  profile_t const* pb = b;
+  if (pa->stack != pb->stack)
+    return pa->stack < pb->stack ? 1 : -1;
+  return (int)pa->num - (int)pb->num;
+}
+
+static void recommend(profile_t const* profiles, unsigned count, int fsk, float scale, unsigned reserve) {
+  profile_t const* deepest = NULL;
+  profile_t const* heaviest = NULL;
+  unsigned selected = 0;
+  unsigned trains = 0;
+  for (unsigned i = 0; i < count; ++i) {
+    profile_t const* p = &profiles[i];
+    if (!p->selected || p->fsk != fsk)
+      continue;
+    selected++;
+    trains += p->trains;
+    if (!deepest || p->stack > deepest->stack)
+      deepest = p;
+    if (!heaviest || p->heap + p->setup > heaviest->heap + heaviest->setup)
+      heaviest = p;
+  }
+  if (!selected)
+    return;
+  if (!trains) {
+    printf("%s: %u decoders, no trains in the captures\n", fsk ? "FSK" : "OOK", selected);
+    return;
+  }
+  printf("%s: %u decoders, deepest %s ( %u bytes ), peak heap %s ( %ld bytes )\n", fsk ? "FSK" : "OOK", selected,
+         devices[deepest->num]->name, deepest->stack, devices[heaviest->num]->name, heaviest->heap + heaviest->setup);
+  printf("%s: recommended rtl_433_Decoder_Stack %u ( %u * %.2f + %u )\n", fsk ? "FSK" : "OOK",
+         stack_profile_recommend(0, deepest->stack, scale, reserve), deepest->stack, scale, reserve);
+}
+
+static void usage(char const* prog) {
+  fprintf(stderr, "usage: %s [-m ook|fsk] [-p NUM,...] [-s SCALE] [-r RESERVE] IN.rcap...\n", prog);
+  exit(1);
+}
+
+int main(int argc, char** argv) {
+  char const* selection = NULL;
+  float scale = 1.25f;
+  unsigned reserve = 2048;
+  int opt;
+  while ((opt = getopt(argc, argv, "m:p:s:r:")) != -1) {
+    switch (opt) {
+      case 'm':
+        if (!strcmp(optarg, "ook"))
+          modulation = 0;
+        else if (!strcmp(optarg, "fsk"))
+          modulation = 1;
+        else
+          usage(argv[0]);
+        break;
+      case 'p': selection = optarg; break;
+      case 's': scale = atof(optarg); break;
+      case 'r': reserve = atoi(optarg); break;
+      default: usage(argv[0]);
+    }
+  }
+  if (optind >= argc)
+    usage(argv[0]);
+
+  num_captures = argc - optind;
+  captures = calloc(num_captures, sizeof(*captures));
+  for (unsigned c = 0; c < num_captures; ++c) {
+    char const* path = argv[optind + c];
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st)) {
+      perror(path);
+      return 1;
+    }
+    void* map = st.st_size ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED || pulse_capture_reader_init(&captures[c].reader, map, st.st_size)) {
+      fprintf(stderr, "%s: not a pulse capture\n", path);
+      return 1;
+    }
+    captures[c].map = map;
+    captures[c].len = st.st_size;
+  }
+
+  profile_t* profiles = calloc(NUM_DEVICES, sizeof(*profiles));
+  unsigned count = 0;
+  for (unsigned i = 0; i < NUM_DEVICES; ++i) {
+    int fsk = devices[i]->modulation >= FSK_DEMOD_MIN_VAL;
+    if (modulation >= 0 && fsk != modulation)
+      continue;
+    profile_t* p = &profiles[count++];
+    p->num = i;
+    p->fsk = fsk;
+    p->selected = devices[i]->disabled <= 0; // as registered on the device
+  }
+  if (selection) {
+    for (unsigned i = 0; i < count; ++i)
+      profiles[i].selected = 0;
+    for (char const* s = selection; *s;) {
+      char* end;
+      unsigned num = strtoul(s, &end, 10);
+      if (end == s)
+        usage(argv[0]);
+      for (unsigned i = 0; i < count; ++i) {
+        if (profiles[i].num == num)
+          profiles[i].selected = 1;
+      }
+      s = *end == ',' ? end + 1 : end;
+    }
+  }
+
+  for (unsigned i = 0; i < count; ++i)
+    profile_decoder(&profiles[i]);
+
+  qsort(profiles, count, sizeof(*profiles), cmp_stack);
+  printf("%4s %-3s %6s %6s %6s %7s %8s  %s\n", "num", "mod", "stack", "heap", "setup", "trains", "messages", "name");
+  for (unsigned i = 0; i < count; ++i) {
+    profile_t const* p = &profiles[i];
+    printf("%4u %-3s %6u %6ld %6ld %7u %8u %c%s\n", p->num, p->fsk ? "FSK" : "OOK", p->stack, p->heap, p->setup,
+           p->trains, p->messages, p->selected ? ' ' : '-', devices[p->num]->name);
+  }
+  printf("\n");
+  recommend(profiles, count, 0, scale, reserve);
+  recommend(profiles, count, 1, scale, reserve);
+
+  for (unsigned c = 0; c < num_captures; ++c) {
+    pulse_capture_reader_free(&captures[c].reader);
+    munmap(captures[c].map, captures[c].len);
+  }
+  free(captures);
+  free(profiles);
+  return 0;
+}
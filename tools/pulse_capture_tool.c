@@ -0,0 +1,262 @@
+/** @file
+    Convert pulse captures between the binary capture container and text.
+
+    Build on the host:
+
+        cc -O2 -Iinclude -o pulse_capture_tool tools/pulse_capture_tool.c src/rtl_433/pulse_capture.c src/rtl_433/rfraw.c
+
+    Usage:
+
+        pulse_capture_tool pack OUT.rcap [IN...]  pack OOK text files and device logs
+        pulse_capture_tool unpack IN.rcap         print OOK text, as pulse_data_dump()
+        pulse_capture_tool vcd IN.rcap            print VCD, as pulse_data_print_vcd()
+        pulse_capture_tool info IN.rcap           print a summary
+
+    pack reads OOK text (";ook"/";fsk" headers, "pulse gap" lines in us and ";end")
+    the RAW lines of device logs, "RAW (duration): +p-g...", RfRaw lines,
+    "AAB0...55" or "rfraw:AAB0...", and the RFRAW lines of device logs that
+    do not follow a RAW line.
+    Inputs are read from stdin if none are given.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pulse_capture.h"
+#include "pulse_data.h"
+#include "rfraw.h"
+
+static pulse_data_t train;
+
+static size_t file_write(void const* buf, size_t len, void* ctx) {
+  return fwrite(buf, 1, len, (FILE*)ctx);
+}
+
+static void pack_train(pulse_capture_writer_t* writer, pulse_data_t* data, unsigned* count) {
+  if (!data->num_pulses)
+    return;
+  if (pulse_capture_write(writer, data)) {
+    fprintf(stderr, "write error\n");
+    exit(1);
+  }
+  (*count)++;
+  memset(data, 0, sizeof(*data));
+  data->sample_rate = 1000000;
+}
+
+/// Parse a device log line, "RAW (duration): +p-g(rssi)+p-g..." or "RFRAW (duration): AAB0...".
+static void parse_log(char const* p, pulse_data_t* data, int rfraw) {
+  data->signalDuration = strtoul(strchr(p, '(') + 1, (char**)&p, 10);
+  p = strchr(p, ':');
+  if (!p)
+    return;
+  if (rfraw)
+    rfraw_parse(data, p + 1);
+  else
+    pulse_str_parse(data, p + 1);
+}
+
+static void pack_file(pulse_capture_writer_t* writer, FILE* fp, unsigned* count) {
+  char line[8192];
+  int block = 0; // within a ";ook"/";fsk" ... ";end" block
+  int raw_line = 0;
+  while (fgets(line, sizeof(line), fp)) {
+    // with RAW_SIGNAL_DEBUG unparsed signals are logged in both forms, the RAW line is exact
+    char const* rfraw = strstr(line, "RFRAW (");
+    if (rfraw) {
+      if (!raw_line) {
+        pack_train(writer, &train, count);
+        parse_log(rfraw, &train, 1);
+        pack_train(writer, &train, count);
+      }
+      raw_line = 0;
+      continue;
+    }
+    char const* raw = strstr(line, "RAW (");
+    if (raw) {
+      raw_line = 1; // the RFRAW line of the train follows after the "Unparsed" line
+      pack_train(writer, &train, count);
+      parse_log(raw, &train, 0);
+      pack_train(writer, &train, count);
+      continue;
+    }
+    if (rfraw_check(line)) {
+      pack_train(writer, &train, count);
+      rfraw_parse(&train, line);
+      pack_train(writer, &train, count);
+      continue;
+    }
+    if (*line == ';') {
+      if (!strncmp(line, ";ook", 4) || !strncmp(line, ";fsk", 4)) {
+        pack_train(writer, &train, count); // next header found
+        train.fsk_f2_est = line[1] == 'f';
+        block = 1;
+      } else if (!strncmp(line, ";end", 4)) {
+        pack_train(writer, &train, count);
+        block = 0;
+      } else if (!strncmp(line, ";freq1", 6))
+        train.freq1_hz = strtol(line + 6, NULL, 10);
+      else if (!strncmp(line, ";freq2", 6))
+        train.freq2_hz = strtol(line + 6, NULL, 10);
+      continue;
+    }
+    // "pulse gap" lines, only within a block as log lines start with numbers too
+    if (!block)
+      continue;
+    char* end;
+    long pulse = strtol(line, &end, 10);
+    if (end == line)
+      continue;
+    char* gap_end;
+    long gap = strtol(end, &gap_end, 10);
+    if (gap_end == end || pulse <= 0 || gap <= 0) {
+      fprintf(stderr, "skipping invalid pulse line: %s", line);
+      continue;
+    }
+    if (train.num_pulses < PD_MAX_PULSES) {
+      train.pulse[train.num_pulses] = pulse;
+      train.gap[train.num_pulses++] = gap;
+    }
+  }
+  pack_train(writer, &train, count);
+}
+
+static int pack(char const* path, int argc, char** argv) {
+  FILE* out = fopen(path, "wb");
+  if (!out) {
+    perror(path);
+    return 1;
+  }
+  pulse_capture_writer_t writer;
+  pulse_capture_writer_init(&writer, file_write, out);
+  train.sample_rate = 1000000;
+  unsigned count = 0;
+  if (argc == 0)
+    pack_file(&writer, stdin, &count);
+  for (int i = 0; i < argc; ++i) {
+    FILE* fp = fopen(argv[i], "r");
+    if (!fp) {
+      perror(argv[i]);
+      return 1;
+    }
+    pack_file(&writer, fp, &count);
+    fclose(fp);
+  }
+  int ret = pulse_capture_writer_close(&writer);
+  if (fclose(out) || ret) {
+    fprintf(stderr, "%s: write error\n", path);
+    return 1;
+  }
+  fprintf(stderr, "%u trains, %u bytes\n", count, writer.pos);
+  return 0;
+}
+
+static void print_ook(pulse_data_t const* data) {
+  printf(";received\n");
+  printf(data->fsk_f2_est ? ";fsk %u pulses\n" : ";ook %u pulses\n", data->num_pulses);
+  printf(";freq1 %.0f\n", data->freq1_hz);
+  if (data->fsk_f2_est)
+    printf(";freq2 %.0f\n", data->freq2_hz);
+  printf(";samplerate %u Hz\n", data->sample_rate);
+  printf(";rssi %d dB\n", data->signalRssi);
+  double to_us = data->sample_rate ? 1e6 / data->sample_rate : 1; // widths in us without a rate
+  for (unsigned i = 0; i < data->num_pulses; ++i)
+    printf("%.0f %.0f\n", data->pulse[i] * to_us, data->gap[i] * to_us);
+  printf(";end\n");
+}
+
+static void print_vcd(pulse_data_t const* data, uint64_t* pos) {
+  // trains without offset are laid out one after the other
+  if (data->offset > *pos)
+    *pos = data->offset;
+  double scale = data->sample_rate ? 1e6 / data->sample_rate : 1; // unit: 1 us
+  for (unsigned n = 0; n < data->num_pulses; ++n) {
+    if (n == 0)
+      printf("#%.f 1/ 1'\n", *pos * scale);
+    else
+      printf("#%.f 1'\n", *pos * scale);
+    *pos += data->pulse[n];
+    printf("#%.f 0'\n", *pos * scale);
+    *pos += data->gap[n];
+  }
+  if (data->num_pulses > 0)
+    printf("#%.f 0/\n", *pos * scale);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s pack OUT.rcap [IN...] | unpack IN.rcap | vcd IN.rcap | info IN.rcap\n", argv[0]);
+    return 1;
+  }
+  if (!strcmp(argv[1], "pack"))
+    return pack(argv[2], argc - 3, argv + 3);
+
+  int fd = open(argv[2], O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st)) {
+    perror(argv[2]);
+    return 1;
+  }
+  void* map = st.st_size ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  if (map == MAP_FAILED) {
+    perror(argv[2]);
+    return 1;
+  }
+  pulse_capture_reader_t reader;
+  if (pulse_capture_reader_init(&reader, map, st.st_size)) {
+    fprintf(stderr, "%s: not a pulse capture\n", argv[2]);
+    return 1;
+  }
+
+  int vcd = !strcmp(argv[1], "vcd");
+  int info = !strcmp(argv[1], "info");
+  if (!vcd && !info && strcmp(argv[1], "unpack")) {
+    fprintf(stderr, "unknown command %s\n", argv[1]);
+    return 1;
+  }
+  if (vcd) {
+    printf("$timescale 1 us $end\n");
+    printf("$scope module rtl_433 $end\n");
+    printf("$var wire 1 / FRAME $end\n");
+    printf("$var wire 1 ' AM $end\n");
+    printf("$upscope $end\n");
+    printf("$enddefinitions $end\n");
+    printf("#0 0/ 0'\n");
+  } else if (!info) {
+    printf(";pulse data\n");
+    printf(";version 1\n");
+    printf(";timescale 1us\n");
+  }
+
+  uint64_t pos = 0;
+  unsigned long pulses = 0;
+  for (unsigned n = 0; n < reader.num_trains; ++n) {
+    if (pulse_capture_read(&reader, n, &train)) {
+      fprintf(stderr, "%s: train %u is corrupt\n", argv[2], n);
+      continue;
+    }
+    pulses += train.num_pulses;
+    if (vcd)
+      print_vcd(&train, &pos);
+    else if (!info)
+      print_ook(&train);
+  }
+  if (info)
+    printf("%s: %u trains, %lu pulses, %lld bytes, %s\n", argv[2], reader.num_trains, pulses, (long long)st.st_size,
+           reader.index ? "indexed" : "no index");
+
+  pulse_capture_reader_free(&reader);
+  munmap(map, st.st_size);
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,206 @@
+/** @file
+    Benchmark the specialized PWM and PPM slicers against the generic ones.
+
+    Build on the host:
+
+        cc -O2 -DNDEBUG -DSPECIALIZED_SLICERS -Iinclude -ffunction-sections -fdata-sections \
+            -o slicer_bench tools/slicer_bench.c src/rtl_433/[a-z]*.c src/rtl_433/devices/[a-z]*.c \
+            -Wl,--gc-sections -lm
+
+    Usage:
+
+        slicer_bench [-r ROUNDS] [-u] [-v] IN.rcap...
+
+    Every PWM and PPM decoder with a specialized slicer slices all trains
+    of the captures ROUNDS times (default 20) with the generic and with
+    the specialized slicer.  The decode function is replaced by a
+    checksum of the bitbuffer, the rows of both slicers must be equal.
+    The trains have pulse classes as on the device, -u slices them
+    without.  -v prints the times of every decoder.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bitbuffer.h"
+#include "pulse_capture.h"
+#include "pulse_classes.h"
+#include "pulse_data.h"
+#include "pulse_slicer.h"
+#include "r_api.h"
+#include "r_device.h"
+#include "r_private.h"
+#include "rtl_433.h"
+#include "rtl_433_devices.h"
+
+static r_device* const devices[] = {
+#define DECL(name) &name,
+    DEVICES
+#undef DECL
+};
+#define NUM_DEVICES (sizeof(devices) / sizeof(*devices))
+
+static uint32_t checksum;
+
+/// Hash the rows instead of decoding them.
+static int checksum_decode(r_device* decoder, bitbuffer_t* bitbuffer) {
+  (void)decoder;
+  uint32_t h = checksum ^ bitbuffer->num_rows;
+  for (unsigned row = 0; row < bitbuffer->num_rows; ++row) {
+    h = h * 31 + bitbuffer->bits_per_row[row];
+    for (unsigned i = 0; i < (bitbuffer->bits_per_row[row] + 7u) / 8; ++i)
+      h = h * 31 + bitbuffer->bb[row][i];
+  }
+  checksum = h;
+  return 0;
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static pulse_data_t** trains;
+static unsigned num_trains;
+
+/// Time rounds of slicing all trains, returns ns.
+static double slice_all(int (*slicer)(pulse_data_t const*, r_device*), r_device* r_dev, unsigned rounds, uint32_t* sum) {
+  checksum = 0;
+  double start = now_ns();
+  for (unsigned r = 0; r < rounds; ++r) {
+    for (unsigned t = 0; t < num_trains; ++t)
+      slicer(trains[t], r_dev);
+  }
+  *sum = checksum;
+  return now_ns() - start;
+}
+
+static int load_capture(char const* path, int classes) {
+  FILE* fp = fopen(path, "rb");
+  if (!fp) {
+    perror(path);
+    return -1;
+  }
+  fseek(fp, 0, SEEK_END);
+  long len = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  void* buf = len > 0 ? malloc(len) : NULL;
+  if (!buf || fread(buf, 1, len, fp) != (size_t)len) {
+    fprintf(stderr, "%s: read failed\n", path);
+    fclose(fp);
+    return -1;
+  }
+  fclose(fp);
+
+  pulse_capture_reader_t reader;
+  if (pulse_capture_reader_init(&reader, buf, len)) {
+    fprintf(stderr, "%s: not a pulse capture\n", path);
+    return -1;
+  }
+  trains = realloc(trains, (num_trains + reader.num_trains) * sizeof(*trains));
+  if (!trains)
+    return -1;
+  for (unsigned n = 0; n < reader.num_trains; ++n) {
+    pulse_data_t* pulses = calloc(1, sizeof(*pulses));
+    if (!pulses || pulse_capture_read(&reader, n, pulses)) {
+      fprintf(stderr, "%s: train %u is corrupt\n", path, n);
+      free(pulses);
+      continue;
+    }
+    pulses->sample_rate = 1.0e6; // as on the device
+    if (classes) {
+      pulse_classes_t* c = malloc(sizeof(*c));
+      if (c)
+        pulse_classes_build(c, pulses);
+    }
+    trains[num_trains++] = pulses;
+  }
+  pulse_capture_reader_free(&reader);
+  free(buf);
+  return 0;
+}
+
+static void usage(char const* argv0) {
+  fprintf(stderr, "usage: %s [-r ROUNDS] [-u] [-v] IN.rcap...\n", argv0);
+  exit(1);
+}
+
+int main(int argc, char** argv) {
+  unsigned rounds = 20;
+  int classes = 1;
+  int verbose = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "r:uv")) != -1) {
+    if (opt == 'r')
+      rounds = atoi(optarg);
+    else if (opt == 'u')
+      classes = 0;
+    else if (opt == 'v')
+      verbose = 1;
+    else
+      usage(argv[0]);
+  }
+  if (optind >= argc || rounds < 1)
+    usage(argv[0]);
+  for (int i = optind; i < argc; ++i) {
+    if (load_capture(argv[i], classes))
+      return 1;
+  }
+
+  r_cfg_t cfg = {0};
+  r_init_cfg(&cfg);
+  double total_generic = 0;
+  double total_fixed = 0;
+  unsigned slicers = 0;
+  unsigned mismatches = 0;
+  if (verbose)
+    fprintf(stderr, "  generic ms  fixed ms  speedup  protocol\n");
+  for (unsigned i = 0; i < NUM_DEVICES; ++i) {
+    unsigned m = devices[i]->modulation;
+    if (devices[i]->disabled > 0 || (m != OOK_PULSE_PWM && m != OOK_PULSE_PPM && m != FSK_PULSE_PWM))
+      continue;
+    register_protocol(&cfg, devices[i], NULL);
+    r_device* r_dev = cfg.demod->r_devs.elems[cfg.demod->r_devs.len - 1];
+    if (!r_dev->slicer_fn) {
+      if (verbose)
+        fprintf(stderr, "  no specialized slicer for %s\n", r_dev->name);
+      continue;
+    }
+    r_dev->decode_fn = checksum_decode;
+    r_dev->verbose = 0;
+
+    uint32_t sum_generic, sum_fixed;
+    int (*generic)(pulse_data_t const*, r_device*) = m == OOK_PULSE_PPM ? pulse_slicer_ppm : pulse_slicer_pwm;
+    double t_generic = slice_all(generic, r_dev, rounds, &sum_generic);
+    double t_fixed = slice_all(r_dev->slicer_fn, r_dev, rounds, &sum_fixed);
+    if (sum_generic != sum_fixed) {
+      fprintf(stderr, "  rows differ for %s\n", r_dev->name);
+      mismatches++;
+    }
+    if (verbose)
+      fprintf(stderr, "%12.2f %9.2f %8.2f  %s\n", t_generic / 1e6, t_fixed / 1e6, t_generic / t_fixed, r_dev->name);
+    total_generic += t_generic;
+    total_fixed += t_fixed;
+    slicers++;
+  }
+
+  unsigned long runs = (unsigned long)slicers * rounds * num_trains;
+  fprintf(stderr, "%u trains, %u slicers, %u rounds%s\n", num_trains, slicers, rounds, classes ? "" : ", no pulse classes");
+  if (runs)
+    fprintf(stderr, "generic %.0f ns, specialized %.0f ns per train and slicer, speedup %.2f\n",
+            total_generic / runs, total_fixed / runs, total_generic / total_fixed);
+  if (mismatches)
+    fprintf(stderr, "%u slicers produced different rows\n", mismatches);
+  r_free_cfg(&cfg);
+  return mismatches ? 1 : 0;
+}
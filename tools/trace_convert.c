@@ -0,0 +1,214 @@
+/** @file
+    Convert event trace dumps into a Chrome / Perfetto trace.
+
+    Build on the host:
+
+        cc -O2 -Iinclude -o trace_convert tools/trace_convert.c
+
+    Usage:
+
+        trace_convert [IN...] > trace.json
+
+    Reads binary dumps ( "RTRC" ) and device logs with the hex lines of
+    dumpTrace(), "TRACE 52545243...", from the inputs or stdin.  All dumps
+    found are converted, the timestamps are device micro seconds.  Open
+    the result in chrome://tracing or https://ui.perfetto.dev.
+
+    Every core is a thread and the interrupt handler on a core is a
+    thread of its own.  _BEGIN and _END events become slices, the other
+    events instants with the argument.  Decoder slices are named after
+    the protocol number, see the memcpy lines in signalDecoder.cpp.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+*/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+
+/// Names of the events, slices have a phase of 'B' or 'E'.
+static struct {
+  char const* name;
+  char phase;
+  char const* arg;
+} const events[TRACE_EVENTS] = {
+    [TRACE_NONE]           = {"none", 'i', NULL},
+    [TRACE_EDGE_FIRST]     = {"first edge", 'i', "pulses"},
+    [TRACE_EDGE]           = {"edge", 'i', "pulses"},
+    [TRACE_PULSE_WRAP]     = {"pulse buffer wrap", 'i', NULL},
+    [TRACE_TRAIN_SPLIT]    = {"train split", 'i', "pulses"},
+    [TRACE_SIGNAL_START]   = {"signal start", 'i', "rssi"},
+    [TRACE_SIGNAL_END]     = {"signal end", 'i', "pulses"},
+    [TRACE_SIGNAL_IGNORED] = {"signal ignored", 'i', "pulses"},
+    [TRACE_TRAIN_COPY]     = {"train copy", 'i', "pulses"},
+    [TRACE_TRAIN_QUEUED]   = {"train queued", 'i', "waiting"},
+    [TRACE_TRAIN_DROPPED]  = {"train dropped", 'i', "reason"},
+    [TRACE_DECODE_BEGIN]   = {"decode", 'B', "pulses"},
+    [TRACE_DECODE_END]     = {"decode", 'E', "events"},
+    [TRACE_DEMOD_BEGIN]    = {"demod", 'B', "protocol"},
+    [TRACE_DEMOD_END]      = {"demod", 'E', "events"},
+    [TRACE_CALLBACK_BEGIN] = {"callback", 'B', "length"},
+    [TRACE_CALLBACK_END]   = {"callback", 'E', NULL},
+};
+
+static char const* const drop_reasons[] = {"short", "rssi", "noise", "queue full"};
+
+static unsigned char* dump;
+static size_t dump_len;
+static size_t dump_size;
+
+static int first_event = 1;
+static int threads_seen[4];
+static unsigned long long now;
+static uint32_t last_time;
+static int have_time;
+
+static void dump_append(unsigned char const* buf, size_t len) {
+  if (dump_len + len > dump_size) {
+    dump_size = (dump_len + len) * 2;
+    dump = realloc(dump, dump_size);
+    if (!dump) {
+      fprintf(stderr, "out of memory\n");
+      exit(1);
+    }
+  }
+  memcpy(dump + dump_len, buf, len);
+  dump_len += len;
+}
+
+static int hex_value(int c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  c = tolower(c);
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+static void read_file(FILE* fp) {
+  size_t size = 65536;
+  size_t len = 0;
+  char* text = malloc(size + 1);
+  size_t n;
+  while (text && (n = fread(text + len, 1, size - len, fp)) > 0) {
+    len += n;
+    if (len == size)
+      text = realloc(text, (size *= 2) + 1);
+  }
+  if (!text) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+
+  if (len >= 4 && !memcmp(text, "RTRC", 4)) {
+    dump_append((unsigned char*)text, len); // a binary dump
+  } else {
+    // a log, the hex lines of the dumps
+    text[len] = '\0';
+    for (char* line = strtok(text, "\n"); line; line = strtok(NULL, "\n")) {
+      char const* p = strstr(line, "TRACE ");
+      if (!p)
+        continue;
+      for (p += 6; hex_value(p[0]) >= 0 && hex_value(p[1]) >= 0; p += 2) {
+        unsigned char b = hex_value(p[0]) << 4 | hex_value(p[1]);
+        dump_append(&b, 1);
+      }
+    }
+  }
+  free(text);
+}
+
+static uint32_t get_le32(unsigned char const* buf) {
+  return buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t)buf[3] << 24;
+}
+
+static void print_thread(int tid) {
+  if (tid >= 4 || threads_seen[tid])
+    return;
+  threads_seen[tid] = 1;
+  printf("%s\n{\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":\"core %d%s\"}}",
+         first_event ? "" : ",", tid, tid / 2, tid & 1 ? " isr" : "");
+  first_event = 0;
+}
+
+static void print_record(unsigned char const* rec) {
+  uint32_t time = get_le32(rec);
+  unsigned event = rec[4];
+  unsigned core = rec[5];
+  unsigned arg = rec[6] | rec[7] << 8;
+  if (event == TRACE_NONE || event >= TRACE_EVENTS)
+    return;
+
+  // the 32 bit time wraps, records of the two cores may be slightly out of order
+  if (have_time)
+    now += (int32_t)(time - last_time);
+  else
+    now = time;
+  last_time = time;
+  have_time = 1;
+
+  int tid = (core & 0x7f) * 2 + (core & TRACE_CORE_ISR ? 1 : 0);
+  print_thread(tid);
+
+  char name[32];
+  snprintf(name, sizeof(name), "%s", events[event].name);
+  if (event == TRACE_DEMOD_BEGIN)
+    snprintf(name, sizeof(name), "demod %u", arg);
+
+  printf(",\n{\"ph\":\"%c\",\"pid\":0,\"tid\":%d,\"ts\":%llu,\"name\":\"%s\"", events[event].phase, tid, now, name);
+  if (events[event].phase == 'i')
+    printf(",\"s\":\"t\"");
+  if (event == TRACE_TRAIN_DROPPED && arg < sizeof(drop_reasons) / sizeof(*drop_reasons))
+    printf(",\"args\":{\"reason\":\"%s\"}", drop_reasons[arg]);
+  else if (event == TRACE_SIGNAL_START)
+    printf(",\"args\":{\"rssi\":%d}", (int16_t)arg);
+  else if (events[event].arg)
+    printf(",\"args\":{\"%s\":%u}", events[event].arg, arg);
+  printf("}");
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2)
+    read_file(stdin);
+  for (int i = 1; i < argc; ++i) {
+    FILE* fp = fopen(argv[i], "rb");
+    if (!fp) {
+      perror(argv[i]);
+      return 1;
+    }
+    read_file(fp);
+    fclose(fp);
+  }
+
+  printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  unsigned dumps = 0;
+  unsigned long records = 0;
+  size_t pos = 0;
+  while (pos + TRACE_HEADER_LEN <= dump_len) {
+    unsigned char const* header = dump + pos;
+    if (memcmp(header, "RTRC", 4) || header[4] != TRACE_VERSION || header[5] != TRACE_RECORD_LEN) {
+      fprintf(stderr, "no trace dump at byte %zu\n", pos);
+      break;
+    }
+    uint32_t count = get_le32(header + 8);
+    pos += TRACE_HEADER_LEN;
+    if ((dump_len - pos) / TRACE_RECORD_LEN < count) {
+      fprintf(stderr, "trace dump %u is truncated\n", dumps);
+      count = (dump_len - pos) / TRACE_RECORD_LEN;
+    }
+    for (uint32_t n = 0; n < count; ++n, pos += TRACE_RECORD_LEN)
+      print_record(dump + pos);
+    records += count;
+    dumps++;
+  }
+  printf("\n]}\n");
+  fprintf(stderr, "%u dumps, %lu records\n", dumps, records);
+  free(dump);
+  return 0;
+}
@@ -0,0 +1,79 @@
+#! /bin/sh
+
+# Generate include/pulse_slicer_fixed.h, the timings of the PWM and PPM
+# decoders in include/rtl_433_devices.h for the specialized slicers of
+# SPECIALIZED_SLICERS.  Run from tools/ after update_rtl_433_devices.sh.
+
+DEVICES=`grep "DECL(" ../include/rtl_433_devices.h | sed 's/.*DECL(\([A-Za-z0-9_]*\)).*/\1/' | tr '\n' ' '`
+
+( cd ../src/rtl_433/devices ; cat *.c ) | awk -v devices="${DEVICES}" '
+BEGIN {
+  n = split(devices, list, " ")
+  for (i = 1; i <= n; i++)
+    wanted[list[i]] = 1
+  count = 0
+}
+
+# r_device const name = {
+/^r_device .*= *{/ {
+  name = $0
+  sub(/ *=.*/, "", name)
+  sub(/.* /, "", name)
+  inside = 1
+  delete field
+  next
+}
+
+inside && /^};/ {
+  inside = 0
+  m = field["modulation"]
+  if (!(name in wanted) || (m != "OOK_PULSE_PWM" && m != "OOK_PULSE_PPM" && m != "FSK_PULSE_PWM"))
+    next
+  timing = m
+  split("short_width long_width reset_limit gap_limit sync_width tolerance", keys, " ")
+  for (k = 1; k <= 6; k++)
+    timing = timing ", " ((keys[k] in field) ? field[keys[k]] : "0")
+  if (timing in seen) {
+    seen[timing] = seen[timing] " " name
+    next
+  }
+  seen[timing] = name
+  order[count++] = timing
+  next
+}
+
+inside && /^ *\.[a-z_]+ *=/ {
+  line = $0
+  sub(/\/\/.*/, "", line)
+  key = line
+  sub(/^ *\./, "", key)
+  sub(/ *=.*/, "", key)
+  value = line
+  sub(/^[^=]*= */, "", value)
+  sub(/, *$/, "", value)
+  sub(/ *$/, "", value)
+  field[key] = value
+}
+
+END {
+  print "/** @file"
+  print "    Timings of the specialized pulse slicers."
+  print ""
+  print "    This is a generated file from tools/update_pulse_slicer_fixed.sh"
+  print "*/"
+  print ""
+  print "#ifndef INCLUDE_PULSE_SLICER_FIXED_H_"
+  print "#define INCLUDE_PULSE_SLICER_FIXED_H_"
+  print ""
+  print "// SLICER(index, modulation, short_width, long_width, reset_limit, gap_limit, sync_width, tolerance)"
+  print "#define PULSE_SLICER_FIXED \\"
+  for (i = 0; i < count; i++)
+    printf("  SLICER(%d, %s) /* %s */ \\\n", i, order[i], seen[order[i]])
+  print "  /* end of list */"
+  print ""
+  printf("#define PULSE_SLICER_FIXED_COUNT %d\n", count)
+  print ""
+  print "#endif /* INCLUDE_PULSE_SLICER_FIXED_H_ */"
+}' > ../include/pulse_slicer_fixed.h
+
+echo "pulse_slicer_fixed.h created"
@@ -93,3 +93,7 @@ echo "  // end of fragment" >> decoder.fragment
 
 echo
 
+# create include/pulse_slicer_fixed.h
+
+./update_pulse_slicer_fixed.sh
+